@@ -4,13 +4,16 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
-../Source/Callbacks/CallbackQueue.cpp 
+../Source/Callbacks/CallbackQueue.cpp \
+../Source/Callbacks/Spinner.cpp 
 
 OBJS += \
-./Source/Callbacks/CallbackQueue.o 
+./Source/Callbacks/CallbackQueue.o \
+./Source/Callbacks/Spinner.o 
 
 CPP_DEPS += \
-./Source/Callbacks/CallbackQueue.d 
+./Source/Callbacks/CallbackQueue.d \
+./Source/Callbacks/Spinner.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -0,0 +1,33 @@
+################################################################################
+# Not generated: every test is an executable of its own, linked by the check
+# target of the makefile, its object stays out of the library
+################################################################################
+
+# Add inputs and outputs from these tool invocations to the build variables 
+CPP_SRCS += \
+../Test/DataSet/TestHistory.cpp \
+../Test/DataSet/TestRing.cpp 
+
+TEST_OBJS += \
+./Test/DataSet/TestHistory.o \
+./Test/DataSet/TestRing.o 
+
+TESTS += \
+TestHistory \
+TestRing 
+
+CPP_DEPS += \
+./Test/DataSet/TestHistory.d \
+./Test/DataSet/TestRing.d 
+
+TestHistory: ./Test/DataSet/TestHistory.o
+TestRing: ./Test/DataSet/TestRing.o
+
+# Each subdirectory must supply rules for building sources it contributes
+Test/DataSet/%.o: ../Test/DataSet/%.cpp
+	@echo 'Building file: $<'
+	@echo 'Invoking: Cross G++ Compiler'
+	arm-openwrt-linux-muslgnueabi-g++ -I"../Source" -O0 -g3 -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@)" -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
@@ -0,0 +1,28 @@
+################################################################################
+# Not generated: every test is an executable of its own, linked by the check
+# target of the makefile, its object stays out of the library
+################################################################################
+
+# Add inputs and outputs from these tool invocations to the build variables 
+CPP_SRCS += \
+../Test/Serialization/TestSerialization.cpp 
+
+TEST_OBJS += \
+./Test/Serialization/TestSerialization.o 
+
+TESTS += \
+TestSerialization 
+
+CPP_DEPS += \
+./Test/Serialization/TestSerialization.d 
+
+TestSerialization: ./Test/Serialization/TestSerialization.o
+
+# Each subdirectory must supply rules for building sources it contributes
+Test/Serialization/%.o: ../Test/Serialization/%.cpp
+	@echo 'Building file: $<'
+	@echo 'Invoking: Cross G++ Compiler'
+	arm-openwrt-linux-muslgnueabi-g++ -I"../Source" -O0 -g3 -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@)" -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
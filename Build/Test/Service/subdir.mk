@@ -0,0 +1,38 @@
+################################################################################
+# Not generated: every test is an executable of its own, linked by the check
+# target of the makefile, its object stays out of the library
+################################################################################
+
+# Add inputs and outputs from these tool invocations to the build variables 
+CPP_SRCS += \
+../Test/Service/TestMapSync.cpp \
+../Test/Service/TestServiceCall.cpp \
+../Test/Service/TestServiceRecovery.cpp 
+
+TEST_OBJS += \
+./Test/Service/TestMapSync.o \
+./Test/Service/TestServiceCall.o \
+./Test/Service/TestServiceRecovery.o 
+
+TESTS += \
+TestMapSync \
+TestServiceCall \
+TestServiceRecovery 
+
+CPP_DEPS += \
+./Test/Service/TestMapSync.d \
+./Test/Service/TestServiceCall.d \
+./Test/Service/TestServiceRecovery.d 
+
+TestMapSync: ./Test/Service/TestMapSync.o
+TestServiceCall: ./Test/Service/TestServiceCall.o
+TestServiceRecovery: ./Test/Service/TestServiceRecovery.o
+
+# Each subdirectory must supply rules for building sources it contributes
+Test/Service/%.o: ../Test/Service/%.cpp
+	@echo 'Building file: $<'
+	@echo 'Invoking: Cross G++ Compiler'
+	arm-openwrt-linux-muslgnueabi-g++ -I"../Source" -O0 -g3 -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@)" -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
@@ -0,0 +1,24 @@
+################################################################################
+# Not generated: shmstat is an executable of its own, its object is linked by
+# the shmstat target of the makefile and stays out of the library
+################################################################################
+
+# Add inputs and outputs from these tool invocations to the build variables 
+CPP_SRCS += \
+../Tools/ShmStat/ShmStat.cpp 
+
+TOOL_OBJS += \
+./Tools/ShmStat/ShmStat.o 
+
+CPP_DEPS += \
+./Tools/ShmStat/ShmStat.d 
+
+
+# Each subdirectory must supply rules for building sources it contributes
+Tools/ShmStat/%.o: ../Tools/ShmStat/%.cpp
+	@echo 'Building file: $<'
+	@echo 'Invoking: Cross G++ Compiler'
+	arm-openwrt-linux-muslgnueabi-g++ -O0 -g3 -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@)" -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
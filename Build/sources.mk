@@ -16,6 +16,9 @@ LIBRARIES :=
 CC_DEPS := 
 C++_DEPS := 
 OBJS := 
+TOOL_OBJS := 
+TEST_OBJS := 
+TESTS := 
 C_UPPER_DEPS := 
 CXX_DEPS := 
 C_DEPS := 
@@ -31,4 +34,8 @@ Source/Parameter \
 Source/Serialization \
 Source/Time \
 Source/Timer \
+Tools/ShmStat \
+Test/DataSet \
+Test/Service \
+Test/Serialization \
 
@@ -1,5 +1,6 @@
 #include "CallbackQueue.h"
 #include <assert.h>
+#include <algorithm>
 #include <boost/scope_exit.hpp>
 #include <boost/make_shared.hpp>
 
@@ -7,7 +8,7 @@ namespace NS_NaviCommon
 {
 
   CallbackQueue::CallbackQueue(bool enabled)
-      : calling_(0), enabled_(enabled)
+      : next_sequence_(0), calling_(0), enabled_(enabled)
   {
   }
 
@@ -36,6 +37,11 @@ namespace NS_NaviCommon
   {
     boost::mutex::scoped_lock lock(mutex_);
 
+    for(D_CallbackInfo::iterator it = callbacks_.begin();
+        it != callbacks_.end(); ++it)
+    {
+      forget(*it);
+    }
     callbacks_.clear();
   }
 
@@ -76,7 +82,13 @@ namespace NS_NaviCommon
         return;
       }
 
+      info.sequence = ++next_sequence_;
       callbacks_.push_back(info);
+
+      if(removal_id)
+      {
+        pending_ids_[removal_id].push_back(info.sequence);
+      }
     }
 
     {
@@ -106,6 +118,122 @@ namespace NS_NaviCommon
     return IDInfoPtr();
   }
 
+  /*
+   * called with mutex_ held: no other thread is in a callback of id, and no
+   * older callback of id is waiting
+   */
+  bool CallbackQueue::callableInThisThread(unsigned long id,
+                                           uint64_t sequence)
+  {
+    if(id == 0)
+    {
+      return true;
+    }
+
+    M_PendingIDs::iterator pending = pending_ids_.find(id);
+    if(pending != pending_ids_.end() && sequence > pending->second.front())
+    {
+      return false;
+    }
+
+    M_CallingInfo::iterator it = calling_ids_.find(id);
+    return it == calling_ids_.end()
+        || it->second.thread == boost::this_thread::get_id();
+  }
+
+  bool CallbackQueue::claimID(unsigned long id, uint64_t sequence)
+  {
+    if(id == 0)
+    {
+      return true;
+    }
+
+    boost::mutex::scoped_lock lock(mutex_);
+    if(!callableInThisThread(id, sequence))
+    {
+      return false;
+    }
+
+    M_PendingIDs::iterator pending = pending_ids_.find(id);
+    if(pending != pending_ids_.end()
+        && pending->second.front() == sequence)
+    {
+      pending->second.pop_front();
+      if(pending->second.empty())
+      {
+        pending_ids_.erase(pending);
+      }
+    }
+
+    CallingInfo& info = calling_ids_[id];
+    if(info.depth == 0)
+    {
+      info.thread = boost::this_thread::get_id();
+    }
+    info.depth++;
+
+    return true;
+  }
+
+  void CallbackQueue::releaseID(unsigned long id)
+  {
+    if(id == 0)
+    {
+      return;
+    }
+
+    boost::mutex::scoped_lock lock(mutex_);
+    M_CallingInfo::iterator it = calling_ids_.find(id);
+    if(it != calling_ids_.end() && --it->second.depth == 0)
+    {
+      calling_ids_.erase(it);
+
+      // Threads waiting for a callback of this id may take it now
+      condition_.notify_all();
+    }
+  }
+
+  /*
+   * called with mutex_ held: put a callback which was taken off the queue
+   * but not called back before the callbacks added after it
+   */
+  void CallbackQueue::requeue(const CallbackInfo& info)
+  {
+    D_CallbackInfo::iterator it = callbacks_.begin();
+    while(it != callbacks_.end() && it->sequence < info.sequence)
+    {
+      ++it;
+    }
+    callbacks_.insert(it, info);
+
+    condition_.notify_one();
+  }
+
+  /*
+   * called with mutex_ held: a callback is dropped without being called,
+   * the next one of its id must not wait for it
+   */
+  void CallbackQueue::forget(const CallbackInfo& info)
+  {
+    M_PendingIDs::iterator pending = pending_ids_.find(info.removal_id);
+    if(pending == pending_ids_.end())
+    {
+      return;
+    }
+
+    std::deque< uint64_t >& sequences = pending->second;
+    std::deque< uint64_t >::iterator it = std::lower_bound(
+        sequences.begin(), sequences.end(), info.sequence);
+    if(it != sequences.end() && *it == info.sequence)
+    {
+      sequences.erase(it);
+      if(sequences.empty())
+      {
+        pending_ids_.erase(pending);
+      }
+    }
+  }
+
   void CallbackQueue::removeByID(unsigned long removal_id)
   {
     setupTLS();
@@ -149,6 +277,7 @@ namespace NS_NaviCommon
             ++it;
           }
         }
+        pending_ids_.erase(removal_id);
       }
 
       if(tls_->calling_in_this_thread == id_info->id)
@@ -213,6 +342,8 @@ namespace NS_NaviCommon
         }
       }
 
+      bool busy = false;
+
       D_CallbackInfo::iterator it = callbacks_.begin();
       for(; it != callbacks_.end();)
       {
@@ -220,11 +351,16 @@ namespace NS_NaviCommon
 
         if(info.marked_for_removal)
         {
+          forget(info);
           it = callbacks_.erase(it);
           continue;
         }
 
-        if(info.callback->ready())
+        if(!callableInThisThread(info.removal_id, info.sequence))
+        {
+          busy = true;
+        }
+        else if(info.callback->ready())
         {
           cb_info = info;
           it = callbacks_.erase(it);
@@ -236,6 +372,15 @@ namespace NS_NaviCommon
 
       if(!cb_info.callback)
       {
+        // Everything left belongs to callbacks running in other threads, wait for one of them
+        // to return rather than have the caller spin
+        if(busy && !timeout.isZero())
+        {
+          condition_.timed_wait(
+              lock,
+              boost::posix_time::microseconds(timeout.toSec() * 1000000.0f));
+        }
+
         return TryAgain;
       }
 
@@ -339,6 +484,20 @@ namespace NS_NaviCommon
     IDInfoPtr id_info = getIDInfo(info.removal_id);
     if(id_info)
     {
+      // Another thread is in a callback of the same id, or an older one of it is still waiting:
+      // leave this one to the next pass, in its place
+      if(!info.marked_for_removal && !claimID(info.removal_id, info.sequence))
+      {
+        tls->cb_it = tls->callbacks.erase(tls->cb_it);
+
+        boost::mutex::scoped_lock lock(mutex_);
+        requeue(info);
+
+        return TryAgain;
+      }
+      CallingGuard calling(this,
+                           info.marked_for_removal ? 0 : info.removal_id);
+
       boost::shared_lock< boost::shared_mutex > rw_lock(
           id_info->calling_rw_mutex);
 
@@ -368,11 +527,19 @@ namespace NS_NaviCommon
         }
       }
 
-      // Push TryAgain callbacks to the back of the shared queue
+      // Put TryAgain callbacks back in their place, still ahead of the later ones of their id
       if(result == CallbackInterface::TryAgain && !info.marked_for_removal)
       {
         boost::mutex::scoped_lock lock(mutex_);
-        callbacks_.push_back(info);
+        if(info.removal_id)
+        {
+          std::deque< uint64_t >& sequences = pending_ids_[info.removal_id];
+          sequences.insert(
+              std::lower_bound(sequences.begin(), sequences.end(),
+                               info.sequence),
+              info.sequence);
+        }
+        requeue(info);
 
         return TryAgain;
       }
@@ -382,6 +549,9 @@ namespace NS_NaviCommon
     else
     {
       tls->cb_it = tls->callbacks.erase(tls->cb_it);
+
+      boost::mutex::scoped_lock lock(mutex_);
+      forget(info);
     }
 
     return Called;
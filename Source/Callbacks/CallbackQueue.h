@@ -8,16 +8,25 @@
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/shared_mutex.hpp>
 #include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread.hpp>
 #include <boost/thread/tss.hpp>
 
 #include <list>
 #include <deque>
+#include <map>
+#include <stdint.h>
 
 namespace NS_NaviCommon
 {
 
   /**
    * \brief This is the default implementation of the CallbackQueueInterface
+   *
+   * Several threads may call callOne() or callAvailable() on the same queue,
+   * see Spinner. Callbacks added with the same non-zero removal id are never
+   * called concurrently, and are called in the order they were added: while
+   * one thread is in such a callback, the others put the callbacks of that
+   * id back where they were in the queue and take the next ones.
    */
   class CallbackQueue: public CallbackQueueInterface
   {
@@ -130,20 +139,71 @@ namespace NS_NaviCommon
     IDInfoPtr
     getIDInfo(unsigned long id);
 
+    /*
+     * the thread in a callback of a removal id, and how deep it recursed
+     * into callbacks of that id; guarded by mutex_
+     */
+    struct CallingInfo
+    {
+      CallingInfo()
+          : depth(0)
+      {
+      }
+      boost::thread::id thread;
+      unsigned int depth;
+    };
+    typedef std::map< unsigned long, CallingInfo > M_CallingInfo;
+    M_CallingInfo calling_ids_;
+
+    /*
+     * sequences of the callbacks of each non-zero removal id which were not
+     * called yet, oldest first; guarded by mutex_
+     */
+    typedef std::map< unsigned long, std::deque< uint64_t > > M_PendingIDs;
+    M_PendingIDs pending_ids_;
+    uint64_t next_sequence_;
+
+    bool
+    callableInThisThread(unsigned long id, uint64_t sequence);
+    bool
+    claimID(unsigned long id, uint64_t sequence);
+    void
+    releaseID(unsigned long id);
+
+    struct CallingGuard
+    {
+      CallingGuard(CallbackQueue* queue, unsigned long id)
+          : queue(queue), id(id)
+      {
+      }
+      ~CallingGuard()
+      {
+        queue->releaseID(id);
+      }
+      CallbackQueue* queue;
+      unsigned long id;
+    };
+
     struct CallbackInfo
     {
       CallbackInfo()
-          : removal_id(0), marked_for_removal(false)
+          : removal_id(0), sequence(0), marked_for_removal(false)
       {
       }
       CallbackInterfacePtr callback;
       unsigned long removal_id;
+      uint64_t sequence;
       bool marked_for_removal;
     };
     typedef std::list< CallbackInfo > L_CallbackInfo;
     typedef std::deque< CallbackInfo > D_CallbackInfo;
     D_CallbackInfo callbacks_;
     size_t calling_;
+
+    void
+    requeue(const CallbackInfo& info);
+    void
+    forget(const CallbackInfo& info);
     boost::mutex mutex_;
     boost::condition_variable condition_;
 
@@ -0,0 +1,193 @@
+/*
+ * ReceiveMultiplexer.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: root
+ */
+
+#ifndef _RECEIVE_MULTIPLEXER_H_
+#define _RECEIVE_MULTIPLEXER_H_
+
+#include <list>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include "../Common/Doorbell.h"
+#include "../Common/Liveness.h"
+
+namespace NS_NaviCommon
+{
+
+  /**
+   * \brief Dataset or service end served by the ReceiveMultiplexer instead
+   * of a thread of its own.
+   */
+  class MultiplexedChannel
+  {
+  public:
+    virtual ~MultiplexedChannel()
+    {
+    }
+
+    /**
+     * \brief Check the channel for work without blocking and hand it to the
+     * callback queue of the channel, refreshing its heartbeat. Called by
+     * the multiplexer thread whenever the doorbell rings and at least every
+     * HEARTBEAT_PERIOD.
+     */
+    virtual void
+    poll() = 0;
+  };
+
+  /**
+   * \brief The one thread of a process waiting on all its multiplexed
+   * channels at once.
+   *
+   * Channels given a callback queue record the doorbell of the multiplexer
+   * in their control block, every peer waking them rings it too, and the
+   * multiplexer polls its channels, which queue the work for the spinner
+   * threads of the application. The thread starts with the first channel.
+   */
+  class ReceiveMultiplexer
+  {
+  public:
+    static ReceiveMultiplexer&
+    instance()
+    {
+      static ReceiveMultiplexer multiplexer;
+      return multiplexer;
+    }
+
+    ~ReceiveMultiplexer()
+    {
+      {
+        boost::mutex::scoped_lock lock(channels_lock);
+        active = false;
+      }
+
+      if(bell)
+      {
+        bell->notify();
+        thread.join();
+      }
+
+      releaseDoorbell(doorbell);
+    }
+
+    /**
+     * \brief Doorbell to record in the control blocks of the channels, 0 if
+     * none is available, the channels fall back to threads of their own then
+     */
+    uint32_t getDoorbell()
+    {
+      boost::mutex::scoped_lock lock(channels_lock);
+      return start() ? doorbell : 0;
+    }
+
+    /**
+     * \brief Poll the channel from now on, it is polled once right away
+     */
+    void add(MultiplexedChannel* channel)
+    {
+      boost::mutex::scoped_lock lock(channels_lock);
+      if(!start())
+      {
+        return;
+      }
+
+      channels.push_back(channel);
+      bell->notify();
+    }
+
+    /**
+     * \brief Stop polling the channel, waits for a poll of it in progress
+     */
+    void remove(MultiplexedChannel* channel)
+    {
+      boost::mutex::scoped_lock lock(channels_lock);
+      channels.remove(channel);
+    }
+
+    /**
+     * \brief Poll every channel again soon, e.g. when a channel still has
+     * work left
+     */
+    void wake()
+    {
+      if(bell)
+      {
+        bell->notify();
+      }
+    }
+
+  private:
+    ReceiveMultiplexer()
+        : doorbell(0), bell(NULL), active(false)
+    {
+      /*
+       * map the table first so it is unmapped only after the destructor
+       * stopped the thread waiting on it
+       */
+      doorbellTable();
+    }
+
+    /*
+     * the lock is held during a round of polls, so a channel is never
+     * removed in the middle of its poll
+     */
+    boost::mutex channels_lock;
+    std::list< MultiplexedChannel* > channels;
+
+    uint32_t doorbell;
+    SharedEvent* bell;
+
+    bool active;
+    boost::thread thread;
+
+    /*
+     * claim the doorbell and start the thread on first use, called with
+     * channels_lock held
+     */
+    bool start()
+    {
+      if(bell)
+      {
+        return true;
+      }
+
+      doorbell = claimDoorbell();
+      bell = doorbellEvent(doorbell);
+      if(!bell)
+      {
+        return false;
+      }
+
+      active = true;
+      thread = boost::thread(boost::bind(&ReceiveMultiplexer::run, this));
+      return true;
+    }
+
+    void run()
+    {
+      boost::mutex::scoped_lock lock(channels_lock);
+
+      while(active)
+      {
+        uint32_t seen = bell->snapshot();
+
+        for(std::list< MultiplexedChannel* >::iterator it = channels.begin();
+            it != channels.end(); ++it)
+        {
+          (*it)->poll();
+        }
+
+        lock.unlock();
+        bell->wait(seen, SharedEvent::deadline(HEARTBEAT_PERIOD));
+        lock.lock();
+      }
+    }
+  };
+
+}
+
+#endif /* _RECEIVE_MULTIPLEXER_H_ */
@@ -0,0 +1,118 @@
+#include "Spinner.h"
+#include "../Thread/Atomic.h"
+#include <boost/bind.hpp>
+
+namespace NS_NaviCommon
+{
+
+  /*
+   * how long the threads wait for a callback before they check again whether
+   * they should stop
+   */
+  static const double SPIN_WAIT = 0.1;
+
+  uint32_t spinnerThreadCount(uint32_t thread_count)
+  {
+    if(thread_count == 0)
+    {
+      thread_count = boost::thread::hardware_concurrency();
+    }
+
+    return thread_count ? thread_count : 1;
+  }
+
+  static void spinThread(CallbackQueue* queue)
+  {
+    while(queue->callOne(Duration(SPIN_WAIT)) != CallbackQueue::Disabled)
+    {
+    }
+  }
+
+  void SingleThreadedSpinner::spin(CallbackQueue* queue)
+  {
+    while(queue->isEnabled())
+    {
+      queue->callAvailable(Duration(SPIN_WAIT));
+    }
+  }
+
+  MultiThreadedSpinner::MultiThreadedSpinner(uint32_t thread_count)
+      : thread_count_(spinnerThreadCount(thread_count))
+  {
+  }
+
+  void MultiThreadedSpinner::spin(CallbackQueue* queue)
+  {
+    boost::thread_group threads;
+
+    // The calling thread is one of the pool
+    for(uint32_t i = 1; i < thread_count_; ++i)
+    {
+      threads.create_thread(boost::bind(&spinThread, queue));
+    }
+
+    spinThread(queue);
+
+    threads.join_all();
+  }
+
+  AsyncSpinner::AsyncSpinner(uint32_t thread_count, CallbackQueue* queue)
+      : thread_count_(spinnerThreadCount(thread_count)), queue_(queue),
+        continue_(false)
+  {
+  }
+
+  AsyncSpinner::~AsyncSpinner()
+  {
+    stop();
+  }
+
+  void AsyncSpinner::start()
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+
+    if(continue_)
+    {
+      return;
+    }
+
+    atomicStore(&continue_, true);
+
+    for(uint32_t i = 0; i < thread_count_; ++i)
+    {
+      threads_.push_back(
+          boost::shared_ptr< boost::thread >(
+              new boost::thread(boost::bind(&AsyncSpinner::threadFunc, this))));
+    }
+  }
+
+  void AsyncSpinner::stop()
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+
+    if(!continue_)
+    {
+      return;
+    }
+
+    atomicStore(&continue_, false);
+
+    for(size_t i = 0; i < threads_.size(); ++i)
+    {
+      threads_[i]->join();
+    }
+    threads_.clear();
+  }
+
+  void AsyncSpinner::threadFunc()
+  {
+    while(atomicLoad(&continue_))
+    {
+      if(queue_->callOne(Duration(SPIN_WAIT)) == CallbackQueue::Disabled)
+      {
+        break;
+      }
+    }
+  }
+
+}
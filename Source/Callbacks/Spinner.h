@@ -0,0 +1,114 @@
+#ifndef _SPINNER_H_
+#define _SPINNER_H_
+
+#include "CallbackQueue.h"
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <vector>
+
+namespace NS_NaviCommon
+{
+
+  /**
+   * \brief Abstract interface for classes which call the callbacks of a CallbackQueue
+   *
+   * spin() blocks until the queue is disabled, either by CallbackQueue::disable() from another
+   * thread or a signal handler, or by the queue going away after it returned.
+   */
+  class Spinner
+  {
+  public:
+    virtual ~Spinner()
+    {
+    }
+
+    /**
+     * \brief Call the callbacks of queue until it is disabled
+     */
+    virtual void
+    spin(CallbackQueue* queue) = 0;
+  };
+
+  /**
+   * \brief Calls all callbacks in the thread that calls spin()
+   */
+  class SingleThreadedSpinner: public Spinner
+  {
+  public:
+    virtual void
+    spin(CallbackQueue* queue);
+  };
+
+  /**
+   * \brief Calls callbacks from a pool of threads, spin() blocks until they all returned
+   *
+   * Callbacks of different removal ids run in parallel, those of the same removal id one after
+   * the other, see CallbackQueue.
+   */
+  class MultiThreadedSpinner: public Spinner
+  {
+  public:
+    /**
+     * \param thread_count The number of threads to use, 0 means one per core
+     */
+    MultiThreadedSpinner(uint32_t thread_count = 0);
+
+    virtual void
+    spin(CallbackQueue* queue);
+
+  private:
+    uint32_t thread_count_;
+  };
+
+  /**
+   * \brief Calls callbacks from a pool of threads in the background, between start() and stop()
+   *
+   * Unlike MultiThreadedSpinner it does not block. The queue must outlive the spinner, or at least
+   * the call to stop().
+   */
+  class AsyncSpinner
+  {
+  public:
+    /**
+     * \param thread_count The number of threads to use, 0 means one per core
+     * \param queue The queue to call the callbacks of
+     */
+    AsyncSpinner(uint32_t thread_count, CallbackQueue* queue);
+    ~AsyncSpinner();
+
+    /**
+     * \brief Start the threads, does nothing if they are running already
+     */
+    void
+    start();
+    /**
+     * \brief Stop the threads, waits for the callbacks they are calling to return. Does nothing
+     * if they are not running.
+     */
+    void
+    stop();
+
+  private:
+    void
+    threadFunc();
+
+    uint32_t thread_count_;
+    CallbackQueue* queue_;
+
+    boost::mutex mutex_;
+    std::vector< boost::shared_ptr< boost::thread > > threads_;
+    bool continue_;
+  };
+
+  /**
+   * \brief Number of threads to use when 0 is asked for, one per core
+   */
+  uint32_t
+  spinnerThreadCount(uint32_t thread_count);
+
+}
+
+#endif
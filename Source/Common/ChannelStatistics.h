@@ -0,0 +1,126 @@
+/*
+ * ChannelStatistics.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: root
+ */
+
+#ifndef _CHANNEL_STATISTICS_H_
+#define _CHANNEL_STATISTICS_H_
+
+#include <stdint.h>
+#include "../Thread/Atomic.h"
+#include "../Thread/SharedEvent.h"
+
+namespace NS_NaviCommon
+{
+
+  enum
+  {
+    STATISTICS_LATENCY_BUCKETS = 32,
+  };
+
+  /*
+   * counters of one dataset or service, kept in its control block so any
+   * process can read them, see Tools/ShmStat. latency[i] counts the samples
+   * handled within [2^i, 2^(i+1)) microseconds after they were published,
+   * latency[0] also the faster ones. last_publish is the SharedEvent::now()
+   * of the last publish and period the moving average of the time between
+   * two publishes in nanoseconds, 0 until there were two of them
+   */
+  typedef struct
+  {
+    uint64_t published;
+    uint64_t last_publish;
+    uint64_t period;
+    uint64_t delivered;
+    uint64_t timeouts;
+    uint64_t bytes;
+    uint64_t max_length;
+    uint64_t latency[STATISTICS_LATENCY_BUCKETS];
+  } ChannelStatistics;
+
+  inline uint32_t latencyBucket(uint64_t microseconds)
+  {
+    uint32_t bucket = 0;
+    while(microseconds > 1 && bucket < STATISTICS_LATENCY_BUCKETS - 1)
+    {
+      microseconds >>= 1;
+      bucket++;
+    }
+
+    return bucket;
+  }
+
+  /*
+   * the period is only updated by the publisher holding the lock of the
+   * control block, readers may see it a step behind
+   */
+  inline void recordPublish(ChannelStatistics& statistics, uint64_t count = 1)
+  {
+    atomicFetchAdd(&statistics.published, count);
+
+    uint64_t current = SharedEvent::now();
+    uint64_t last = atomicLoad(&statistics.last_publish);
+    if(last != 0 && current > last)
+    {
+      uint64_t interval = current - last;
+      uint64_t period = atomicLoad(&statistics.period);
+      period = period ? period - period / 8 + interval / 8 : interval;
+      atomicStore(&statistics.period, period);
+    }
+    atomicStore(&statistics.last_publish, current);
+  }
+
+  /*
+   * publishes per second, 0 when unknown or stalled for a few periods
+   */
+  inline double publishRate(ChannelStatistics& statistics)
+  {
+    uint64_t period = atomicLoad(&statistics.period);
+    uint64_t last = atomicLoad(&statistics.last_publish);
+    if(period == 0 || SharedEvent::now() - last > 4 * period + 1000000000ULL)
+    {
+      return 0;
+    }
+
+    return 1e9 / period;
+  }
+
+  inline void recordTransfer(ChannelStatistics& statistics, uint64_t length)
+  {
+    atomicFetchAdd(&statistics.bytes, length);
+
+    uint64_t max_length = atomicLoad(&statistics.max_length);
+    while(length > max_length)
+    {
+      if(atomicCompareExchange(&statistics.max_length, max_length, length))
+      {
+        break;
+      }
+      max_length = atomicLoad(&statistics.max_length);
+    }
+  }
+
+  inline void recordTimeout(ChannelStatistics& statistics)
+  {
+    atomicFetchAdd(&statistics.timeouts, (uint64_t)1);
+  }
+
+  /*
+   * stamp is the SharedEvent::now() of the publish, count the number of
+   * messages delivered together
+   */
+  inline void recordDelivery(ChannelStatistics& statistics, uint64_t stamp,
+                             uint64_t count = 1)
+  {
+    uint64_t current = SharedEvent::now();
+    uint64_t microseconds = current > stamp ? (current - stamp) / 1000 : 0;
+
+    atomicFetchAdd(&statistics.delivered, count);
+    atomicFetchAdd(&statistics.latency[latencyBucket(microseconds)], count);
+  }
+
+}
+
+#endif /* _CHANNEL_STATISTICS_H_ */
@@ -0,0 +1,42 @@
+/*
+ * ContainerTraits.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: root
+ */
+
+#ifndef _CONTAINER_TRAITS_H_
+#define _CONTAINER_TRAITS_H_
+
+#include <string>
+#include <vector>
+
+namespace NS_NaviCommon
+{
+
+  /**
+   * \brief Vector type of a data type field for the given ContainerAllocator.
+   *
+   * std::vector by default; allocators which need containers of their own,
+   * such as the shared memory one, specialize it.
+   */
+  template< typename T, class ContainerAllocator >
+  struct ContainerVector
+  {
+    typedef std::vector< T,
+        typename ContainerAllocator::template rebind< T >::other > Type;
+  };
+
+  /**
+   * \brief String type of a data type field for the given ContainerAllocator.
+   */
+  template< class ContainerAllocator >
+  struct ContainerString
+  {
+    typedef std::basic_string< char, std::char_traits< char >,
+        typename ContainerAllocator::template rebind< char >::other > Type;
+  };
+
+}
+
+#endif /* _CONTAINER_TRAITS_H_ */
@@ -0,0 +1,194 @@
+/*
+ * Doorbell.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: root
+ */
+
+#ifndef _DOORBELL_H_
+#define _DOORBELL_H_
+
+#include <string.h>
+#include <unistd.h>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+#include "Liveness.h"
+#include "../Thread/Atomic.h"
+#include "../Thread/SharedEvent.h"
+#include "../Thread/SharedMutex.h"
+
+namespace NS_NaviCommon
+{
+
+  enum
+  {
+    DOORBELL_COUNT = 64,
+  };
+
+  /*
+   * written last by the process which creates the table
+   */
+  const uint32_t DOORBELL_MAGIC = 0x42454C4C;
+
+  /*
+   * one event per process waiting on many channels at once, see
+   * ReceiveMultiplexer. A channel records the doorbell of such a waiter,
+   * index + 1, and whoever wakes the channel rings it as well
+   */
+  typedef struct
+  {
+    uint32_t magic;
+    SharedMutex lock;
+    uint32_t owners[DOORBELL_COUNT];
+    SharedEvent events[DOORBELL_COUNT];
+  } DoorbellTable;
+
+  inline DoorbellTable*
+  attachDoorbellTable(boost::interprocess::mapped_region& region)
+  {
+    using namespace boost::interprocess;
+
+    shared_memory_object shm;
+    bool creator = false;
+
+    try
+    {
+      try
+      {
+        shm = shared_memory_object(create_only, "NaviCommon_BELL", read_write);
+        shm.truncate(sizeof(DoorbellTable));
+        creator = true;
+      }
+      catch(interprocess_exception& exception)
+      {
+        shm = shared_memory_object(open_only, "NaviCommon_BELL", read_write);
+      }
+
+      if(!creator)
+      {
+        offset_t size = 0;
+        for(int i = 0; i < 1000; i++)
+        {
+          if(shm.get_size(size) && size != 0)
+          {
+            break;
+          }
+          usleep(1000);
+        }
+
+        if(size != sizeof(DoorbellTable))
+        {
+          return NULL;
+        }
+      }
+
+      region = mapped_region(shm, read_write);
+    }
+    catch(interprocess_exception& exception)
+    {
+      return NULL;
+    }
+
+    DoorbellTable* table = static_cast< DoorbellTable* >(region.get_address());
+    if(creator)
+    {
+      table = new (table) DoorbellTable;
+      memset(table->owners, 0, sizeof(table->owners));
+      atomicStore(&table->magic, DOORBELL_MAGIC);
+      return table;
+    }
+
+    for(int i = 0; i < 1000; i++)
+    {
+      if(atomicLoad(&table->magic) == DOORBELL_MAGIC)
+      {
+        return table;
+      }
+      usleep(1000);
+    }
+
+    return NULL;
+  }
+
+  /*
+   * the table shared by every process, mapped once per process; NULL if it
+   * can not be mapped
+   */
+  inline DoorbellTable*
+  doorbellTable()
+  {
+    static boost::interprocess::mapped_region region;
+    static DoorbellTable* table = attachDoorbellTable(region);
+    return table;
+  }
+
+  /*
+   * take a doorbell for this process, those of dead processes are taken
+   * again. Returns 0 if none is left
+   */
+  inline uint32_t claimDoorbell()
+  {
+    DoorbellTable* table = doorbellTable();
+    if(!table)
+    {
+      return 0;
+    }
+
+    boost::interprocess::scoped_lock< SharedMutex > lock(table->lock);
+    table->lock.recovered();
+
+    for(uint32_t i = 0; i < DOORBELL_COUNT; i++)
+    {
+      if(!processAlive(table->owners[i]))
+      {
+        table->owners[i] = currentProcess();
+        return i + 1;
+      }
+    }
+
+    return 0;
+  }
+
+  inline void releaseDoorbell(uint32_t doorbell)
+  {
+    DoorbellTable* table = doorbellTable();
+    if(!table || !doorbell)
+    {
+      return;
+    }
+
+    boost::interprocess::scoped_lock< SharedMutex > lock(table->lock);
+    table->lock.recovered();
+    table->owners[doorbell - 1] = 0;
+  }
+
+  inline void ringDoorbell(uint32_t doorbell)
+  {
+    if(!doorbell || doorbell > DOORBELL_COUNT)
+    {
+      return;
+    }
+
+    DoorbellTable* table = doorbellTable();
+    if(table)
+    {
+      table->events[doorbell - 1].notify();
+    }
+  }
+
+  inline SharedEvent*
+  doorbellEvent(uint32_t doorbell)
+  {
+    DoorbellTable* table = doorbellTable();
+    if(!table || !doorbell || doorbell > DOORBELL_COUNT)
+    {
+      return NULL;
+    }
+
+    return &table->events[doorbell - 1];
+  }
+
+}
+
+#endif /* _DOORBELL_H_ */
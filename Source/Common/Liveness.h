@@ -0,0 +1,74 @@
+/*
+ * Liveness.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: root
+ */
+
+#ifndef _LIVENESS_H_
+#define _LIVENESS_H_
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/types.h>
+
+namespace NS_NaviCommon
+{
+
+  enum
+  {
+    /*
+     * milliseconds between two heartbeats of an idle peer
+     */
+    HEARTBEAT_PERIOD = 1000,
+  };
+
+  inline uint32_t currentProcess()
+  {
+    return (uint32_t)getpid();
+  }
+
+  /*
+   * whether the peer process recorded as pid still runs, 0 is nobody. A
+   * zombie not reaped yet by its parent counts as dead
+   */
+  inline bool processAlive(uint32_t pid)
+  {
+    if(pid == 0)
+    {
+      return false;
+    }
+
+    if(kill((pid_t)pid, 0) != 0 && errno == ESRCH)
+    {
+      return false;
+    }
+
+    char path[32];
+    snprintf(path, sizeof(path), "/proc/%u/stat", pid);
+
+    FILE* file = fopen(path, "r");
+    if(!file)
+    {
+      return true;
+    }
+
+    char stat[256];
+    size_t length = fread(stat, 1, sizeof(stat) - 1, file);
+    fclose(file);
+    stat[length] = 0;
+
+    /*
+     * pid (comm) state ..., comm may contain blanks and parentheses
+     */
+    const char* state = strrchr(stat, ')');
+    return !(state && state[1] == ' ' && state[2] == 'Z');
+  }
+
+}
+
+#endif /* _LIVENESS_H_ */
@@ -443,6 +443,31 @@ namespace NS_NaviCommon
             typename boost::remove_const< M >::type >::type >::value;
   }
 
+#define CREATE_SIMPLE_TRAITS(Type) \
+  template<> struct IsSimple<Type> : public TrueType {}; \
+  template<> struct IsFixedSize<Type> : public TrueType {}; \
+  template<> struct IsSimple<Type const> : public TrueType {}; \
+  template<> struct IsFixedSize<Type const> : public TrueType {};
+
+  /*
+   * scalars, Time and Duration are serialized as they lie in memory, so
+   * vectors and arrays of them are copied in one piece. Not bool, its size
+   * is up to the compiler
+   */
+  CREATE_SIMPLE_TRAITS(char);
+  CREATE_SIMPLE_TRAITS(uint8_t);
+  CREATE_SIMPLE_TRAITS(int8_t);
+  CREATE_SIMPLE_TRAITS(uint16_t);
+  CREATE_SIMPLE_TRAITS(int16_t);
+  CREATE_SIMPLE_TRAITS(uint32_t);
+  CREATE_SIMPLE_TRAITS(int32_t);
+  CREATE_SIMPLE_TRAITS(uint64_t);
+  CREATE_SIMPLE_TRAITS(int64_t);
+  CREATE_SIMPLE_TRAITS(float);
+  CREATE_SIMPLE_TRAITS(double);
+  CREATE_SIMPLE_TRAITS(Time);
+  CREATE_SIMPLE_TRAITS(Duration);
+
 } // namespace ros
 
 #endif // _MESSAGE_TRAITS_H_
@@ -0,0 +1,195 @@
+/*
+ * SharedSegment.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: root
+ */
+
+#ifndef _SHARED_SEGMENT_H_
+#define _SHARED_SEGMENT_H_
+
+#include <string>
+#include <stdint.h>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include "../Thread/Atomic.h"
+
+namespace NS_NaviCommon
+{
+
+  /**
+   * \brief A named payload segment that is created once and stays mapped.
+   *
+   * The capacity and the generation live in a control block shared by all
+   * peers. The writer grows the segment geometrically and bumps the
+   * generation; every peer remaps only when the generation it has mapped
+   * differs from the shared one. The segment is never shrunk, so a stale
+   * mapping stays valid until its owner remaps.
+   *
+   * Readers do not take a lock. The writer stores the capacity and then the
+   * generation, both with release; readers load the generation and then the
+   * capacity with acquire, so the capacity they map is never smaller than
+   * the generation they record.
+   */
+  class SharedSegment
+  {
+  public:
+    enum
+    {
+      MIN_CAPACITY = 4096,
+    };
+
+    SharedSegment()
+        : address_(NULL), mapped_capacity_(0), mapped_generation_(0)
+    {
+    }
+
+    SharedSegment(const std::string& name)
+        : name_(name), address_(NULL), mapped_capacity_(0),
+          mapped_generation_(0)
+    {
+    }
+
+    void setName(const std::string& name)
+    {
+      name_ = name;
+      unmap();
+    }
+
+    const std::string&
+    getName() const
+    {
+      return name_;
+    }
+
+    /**
+     * \brief Writer side: make sure the segment holds at least size bytes.
+     * \param shared_capacity capacity recorded in the control block
+     * \param shared_generation generation recorded in the control block
+     * \param min_capacity lower bound used the first time the segment grows
+     */
+    bool reserve(size_t size, size_t& shared_capacity,
+                 uint32_t& shared_generation, size_t min_capacity = 0)
+    {
+      size_t current = NS_NaviCommon::atomicLoad(&shared_capacity);
+      if(size <= current)
+      {
+        return sync(shared_capacity, shared_generation);
+      }
+
+      size_t capacity = current * 2;
+      if(capacity < min_capacity)
+      {
+        capacity = min_capacity;
+      }
+      if(capacity < MIN_CAPACITY)
+      {
+        capacity = MIN_CAPACITY;
+      }
+      while(capacity < size)
+      {
+        capacity *= 2;
+      }
+
+      try
+      {
+        boost::interprocess::shared_memory_object shm(
+            boost::interprocess::open_or_create, name_.c_str(),
+            boost::interprocess::read_write);
+
+        shm.truncate(capacity);
+      }
+      catch(boost::interprocess::interprocess_exception& exception)
+      {
+        return false;
+      }
+
+      NS_NaviCommon::atomicStore(&shared_capacity, capacity);
+      NS_NaviCommon::atomicStore(&shared_generation, shared_generation + 1);
+
+      return sync(shared_capacity, shared_generation);
+    }
+
+    /**
+     * \brief Reader side: remap if the shared generation moved on.
+     * \param shared_capacity capacity recorded in the control block
+     * \param shared_generation generation recorded in the control block
+     */
+    bool sync(const size_t& shared_capacity, const uint32_t& shared_generation)
+    {
+      uint32_t generation = NS_NaviCommon::atomicLoad(&shared_generation);
+      if(address_ && mapped_generation_ == generation)
+      {
+        return true;
+      }
+
+      size_t capacity = NS_NaviCommon::atomicLoad(&shared_capacity);
+      if(capacity == 0)
+      {
+        return false;
+      }
+
+      try
+      {
+        boost::interprocess::shared_memory_object shm(
+            boost::interprocess::open_only, name_.c_str(),
+            boost::interprocess::read_write);
+
+        region_ = boost::interprocess::mapped_region(
+            shm, boost::interprocess::read_write, 0, capacity);
+      }
+      catch(boost::interprocess::interprocess_exception& exception)
+      {
+        unmap();
+        return false;
+      }
+
+      address_ = static_cast< uint8_t* >(region_.get_address());
+      mapped_capacity_ = capacity;
+      mapped_generation_ = generation;
+
+      return true;
+    }
+
+    void unmap()
+    {
+      region_ = boost::interprocess::mapped_region();
+      address_ = NULL;
+      mapped_capacity_ = 0;
+      mapped_generation_ = 0;
+    }
+
+    bool isMapped() const
+    {
+      return address_ != NULL;
+    }
+
+    uint8_t*
+    getAddress() const
+    {
+      return address_;
+    }
+
+    size_t getCapacity() const
+    {
+      return mapped_capacity_;
+    }
+
+    uint32_t getGeneration() const
+    {
+      return mapped_generation_;
+    }
+
+  private:
+    std::string name_;
+
+    boost::interprocess::mapped_region region_;
+
+    uint8_t* address_;
+    size_t mapped_capacity_;
+    uint32_t mapped_generation_;
+  };
+
+}
+
+#endif /* _SHARED_SEGMENT_H_ */
@@ -0,0 +1,133 @@
+/*
+ * TypeSignature.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: root
+ */
+
+#ifndef _TYPE_SIGNATURE_H_
+#define _TYPE_SIGNATURE_H_
+
+#include <stdint.h>
+#include <string.h>
+#include "MessageTraits.h"
+
+namespace NS_NaviCommon
+{
+
+  enum
+  {
+    TYPE_NAME_LENGTH = 64,
+  };
+
+  /*
+   * what a slot of the dataset holds: the serialized message, or the
+   * handle of a SharedSample in the _OBJ segment
+   */
+  typedef enum
+  {
+    WIRE_SERIALIZED,
+    WIRE_SHARED_OBJECT,
+  } WireFormat;
+
+  /*
+   * type of the messages carried by a dataset or service, kept in its
+   * control block. hash is the MD5Sum of the type, or for the types without
+   * one a hash of its DataType name, Definition, size in memory and
+   * IsFixedSize flag; a zero hash means no type is bound yet. fixed_size
+   * tells whether every message has the same length, wire how the messages
+   * travel, peers of another WireFormat must not attach even for the same
+   * message type
+   */
+  typedef struct
+  {
+    uint64_t hash[2];
+    uint32_t fixed_size;
+    uint32_t wire;
+    char name[TYPE_NAME_LENGTH];
+  } TypeSignature;
+
+  /*
+   * 64 bit FNV-1a
+   */
+  inline uint64_t hashBytes(const void* data, size_t length, uint64_t seed)
+  {
+    const uint8_t* bytes = static_cast< const uint8_t* >(data);
+    uint64_t hash = seed;
+    for(size_t i = 0; i < length; i++)
+    {
+      hash ^= bytes[i];
+      hash *= 0x100000001b3ULL;
+    }
+
+    return hash;
+  }
+
+  inline uint64_t hashName(const char* name, uint64_t seed)
+  {
+    return hashBytes(name, strlen(name), seed);
+  }
+
+  template< typename M >
+  inline TypeSignature typeSignature(WireFormat wire = WIRE_SERIALIZED)
+  {
+    TypeSignature signature;
+    memset(&signature, 0, sizeof(signature));
+
+    const char* name = DataType< M >::value();
+
+    signature.hash[0] = MD5Sum< M >::static_value1;
+    signature.hash[1] = MD5Sum< M >::static_value2;
+    if(signature.hash[0] == 0 && signature.hash[1] == 0)
+    {
+      /*
+       * two builds may give the same name to different layouts, so what is
+       * known of the layout goes into the hash as well
+       */
+      uint64_t layout[2] = { sizeof(M), IsFixedSize< M >::value };
+      uint64_t hash = hashName(name, 0xcbf29ce484222325ULL);
+      hash = hashName(Definition< M >::value(), hash);
+      hash = hashBytes(layout, sizeof(layout), hash);
+
+      signature.hash[0] = hash;
+      signature.hash[1] = hashName(name, hash);
+    }
+
+    signature.fixed_size = IsFixedSize< M >::value;
+    signature.wire = wire;
+    strncpy(signature.name, name, TYPE_NAME_LENGTH - 1);
+
+    return signature;
+  }
+
+  inline bool typeBound(const TypeSignature& signature)
+  {
+    return signature.hash[0] != 0 || signature.hash[1] != 0;
+  }
+
+  inline bool sameType(const TypeSignature& a, const TypeSignature& b)
+  {
+    return a.hash[0] == b.hash[0] && a.hash[1] == b.hash[1]
+        && a.fixed_size == b.fixed_size && a.wire == b.wire;
+  }
+
+  /*
+   * bind signature to the block holding bound, the first typed peer or one
+   * attaching to an abandoned block (rebind) decides the type. Returns false
+   * if the block carries another type, the peer must not attach then
+   */
+  inline bool bindType(TypeSignature& bound, const TypeSignature& signature,
+                       bool rebind)
+  {
+    if(!typeBound(bound) || rebind)
+    {
+      bound = signature;
+      return true;
+    }
+
+    return sameType(bound, signature);
+  }
+
+}
+
+#endif /* _TYPE_SIGNATURE_H_ */
@@ -9,33 +9,593 @@
 #define _DATASET_H_
 
 #include <map>
+#include <string>
+#include <string.h>
+#include <unistd.h>
 #include <boost/thread/thread.hpp>
 #include <boost/thread/mutex.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/function.hpp>
-#include <boost/interprocess/sync/interprocess_condition.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 #include <boost/interprocess/managed_shared_memory.hpp>
+#include "../Thread/Atomic.h"
+#include "../Thread/SharedEvent.h"
+#include "../Thread/SharedMutex.h"
+#include "../Common/Liveness.h"
+#include "../Common/Doorbell.h"
+#include "../Common/ChannelStatistics.h"
+#include "../Common/TypeSignature.h"
+#include "../Serialization/Serialization.h"
 
 namespace NS_DataSet
 {
   using namespace boost::interprocess;
 
+  /*
+   * HANDSHAKE: one slot, publish waits until every subscriber ran its callback.
+   * RING: DATASET_RING_SLOTS slots, publish never waits for the subscribers,
+   *       which drain every pending slot; slots they fell behind on are lost.
+   */
   typedef enum
   {
-    DATASET_IDLE,
-    DATASET_PROCESSING,
-  } DataSetStatus;
+    DATASET_MODE_HANDSHAKE,
+    DATASET_MODE_RING,
+  } DataSetMode;
 
+  enum
+  {
+    DATASET_RING_SLOTS = 16,
+    DATASET_MAX_SUBSCRIBERS = 8,
+  };
+
+  /*
+   * default time in milliseconds a handshake publish waits for the
+   * subscribers, see Publisher::setTimeout()
+   */
+  const unsigned long DATASET_DEFAULT_TIMEOUT = 100;
+
+  /*
+   * written last by the process which creates the control block, peers do
+   * not touch the block before they see it
+   */
+  const uint32_t DATASET_MAGIC = 0x44534554;
+
+  /*
+   * written by the watchdog before it removes an abandoned dataset, peers
+   * still mapping the block attach again
+   */
+  const uint32_t DATASET_RETIRED = 0x44534544;
+
+  /*
+   * one payload slot, guarded by a sequence lock: version is odd while the
+   * publisher rewrites the slot. Samples published as shared objects carry
+   * no payload, handle locates them in the <name>_OBJ segment instead.
+   * count is the number of messages serialized back to back in the slot,
+   * stamp is the SharedEvent::now() of the publish. served is the process
+   * whose in-process subscribers got the sample already, 0 for none
+   */
   typedef struct
   {
-    boost::interprocess::interprocess_mutex lock;
-    boost::interprocess::interprocess_condition req_cond;
-    boost::interprocess::interprocess_condition rep_cond;
-    DataSetStatus status;
+    uint32_t version;
+    uint32_t sequence;
+    size_t length;
+    uint32_t count;
+    managed_shared_memory::handle_t handle;
+    uint64_t stamp;
+    uint32_t served;
+  } DataSetSlot;
 
-    size_t buf_len;
+  /*
+   * history a subscriber keeps: KEEP_ALL takes every sample and a handshake
+   * publish waits for it, any other depth N takes the newest N pending
+   * samples only and never holds the publisher back; LATEST_ONLY is N = 1
+   */
+  enum
+  {
+    DATASET_KEEP_ALL = 0,
+    DATASET_LATEST_ONLY = 1,
+  };
+
+  /*
+   * one attached subscriber, cursor is the sequence it has consumed last,
+   * handshake publishes wait for blocking subscribers only. pid is the
+   * process of the subscriber, heartbeat the SharedEvent::now() it was
+   * last seen running, at least every HEARTBEAT_PERIOD. A local subscriber
+   * is registered in the IntraProcessRegistry of its process and gets the
+   * samples of the publishers there in-process. doorbell is the one of
+   * the ReceiveMultiplexer serving the subscriber, 0 if it has a thread of
+   * its own. pinned holds the handles of the shared samples a
+   * SharedSubscriber has a reference on, 0 for none, so the publisher can
+   * release them when the subscriber dies, see SharedSample
+   */
+  typedef struct
+  {
+    uint32_t active;
+    uint32_t cursor;
+    uint32_t blocking;
+    uint32_t pid;
+    uint64_t heartbeat;
+    uint32_t local;
+    uint32_t doorbell;
+    managed_shared_memory::handle_t pinned[DATASET_RING_SLOTS];
+  } DataSetReader;
+
+  typedef struct
+  {
+    uint32_t magic;
+
+    /*
+     * req_event is notified on every publish, rep_event whenever a
+     * subscriber consumed a sample or detached. The lock survives the
+     * death of its owner, see recoverOperation()
+     */
+    NS_NaviCommon::SharedMutex lock;
+    NS_NaviCommon::SharedEvent req_event;
+    NS_NaviCommon::SharedEvent rep_event;
+
+    /*
+     * capacity of the <name>_DS payload segment, the generation is bumped
+     * whenever the segment grows so peers know when to remap it
+     */
+    size_t capacity;
+    uint32_t generation;
+
+    /*
+     * head is the sequence of the last committed slot, sample n lives in
+     * slot n % count at offset (n % count) * capacity / count, where count
+     * is 1 in handshake mode and DATASET_RING_SLOTS in ring mode
+     */
+    DataSetMode mode;
+    uint32_t head;
+
+    /*
+     * set by a latched publisher, the sample at head stays resident and a
+     * subscriber attaching later starts with it
+     */
+    uint32_t latched;
+    DataSetSlot slots[DATASET_RING_SLOTS];
+
+    DataSetReader readers[DATASET_MAX_SUBSCRIBERS];
+
+    /*
+     * process of the last publisher attached
+     */
+    uint32_t publisher_pid;
+
+    /*
+     * message type bound by the first typed peer, see bindDataSetType()
+     */
+    NS_NaviCommon::TypeSignature type;
+
+    NS_NaviCommon::ChannelStatistics statistics;
   } DataSetOperation;
 
+  inline uint32_t slotCount(DataSetMode mode)
+  {
+    return mode == DATASET_MODE_RING ? DATASET_RING_SLOTS : 1;
+  }
+
+  /*
+   * sequence a subscriber attaching now has consumed last, the one before
+   * head on a latched dataset so the resident sample is delivered first
+   */
+  inline uint32_t attachCursor(DataSetOperation* operation)
+  {
+    uint32_t head = operation->head;
+    if(operation->latched && head != 0)
+    {
+      return head - 1;
+    }
+
+    return head;
+  }
+
+  /*
+   * map the control block of dataset name into region. The first process to
+   * open the dataset constructs the block, every other one waits until it is
+   * published by the magic number
+   */
+  inline DataSetOperation*
+  attachOperation(const std::string& name, mapped_region& region)
+  {
+    shared_memory_object oper_shm;
+    bool creator = false;
+
+    try
+    {
+      oper_shm = shared_memory_object(create_only, name.c_str(), read_write);
+      oper_shm.truncate(sizeof(DataSetOperation));
+      creator = true;
+    }
+    catch(interprocess_exception& exception)
+    {
+      oper_shm = shared_memory_object(open_only, name.c_str(), read_write);
+    }
+
+    if(!creator)
+    {
+      offset_t oper_size = 0;
+      for(int i = 0; i < 1000; i++)
+      {
+        if(oper_shm.get_size(oper_size) && oper_size != 0)
+        {
+          break;
+        }
+        usleep(1000);
+      }
+
+      if(oper_size != sizeof(DataSetOperation))
+      {
+        return NULL;
+      }
+    }
+
+    region = mapped_region(oper_shm, read_write);
+
+    void* region_addr = region.get_address();
+
+    if(creator)
+    {
+      DataSetOperation* oper = new (region_addr) DataSetOperation;
+      oper->capacity = 0;
+      oper->generation = 0;
+      oper->mode = DATASET_MODE_HANDSHAKE;
+      oper->head = 0;
+      oper->latched = 0;
+      oper->publisher_pid = 0;
+      memset(oper->slots, 0, sizeof(oper->slots));
+      memset(oper->readers, 0, sizeof(oper->readers));
+      memset(&oper->type, 0, sizeof(oper->type));
+      memset(&oper->statistics, 0, sizeof(oper->statistics));
+      NS_NaviCommon::atomicStore(&oper->magic, DATASET_MAGIC);
+      return oper;
+    }
+
+    DataSetOperation* oper = static_cast< DataSetOperation* >(region_addr);
+    for(int i = 0; i < 1000; i++)
+    {
+      if(NS_NaviCommon::atomicLoad(&oper->magic) == DATASET_MAGIC)
+      {
+        return oper;
+      }
+      usleep(1000);
+    }
+
+    return NULL;
+  }
+
+  /*
+   * drop the subscribers whose process is gone, so publishers stop waiting
+   * for them and their entries can be taken again; called with the lock
+   * held. Returns how many were dropped
+   */
+  inline int reclaimReaders(DataSetOperation* operation)
+  {
+    int reclaimed = 0;
+    for(int i = 0; i < DATASET_MAX_SUBSCRIBERS; i++)
+    {
+      DataSetReader& reader = operation->readers[i];
+      if(reader.active && !NS_NaviCommon::processAlive(reader.pid))
+      {
+        reader.active = 0;
+        reclaimed++;
+      }
+    }
+
+    if(reclaimed)
+    {
+      operation->rep_event.notify();
+    }
+
+    return reclaimed;
+  }
+
+  /*
+   * whether the entry still records references on shared samples; it is not
+   * taken again until the publisher released them, see SharedSample
+   */
+  inline bool holdsSamples(const DataSetReader& reader)
+  {
+    for(int i = 0; i < DATASET_RING_SLOTS; i++)
+    {
+      if(reader.pinned[i])
+      {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  /*
+   * the lock was taken over from a process that died holding it, a slot it
+   * was rewriting is left odd and must be closed before anybody opens it
+   * again; called with the lock held
+   */
+  inline void recoverOperation(DataSetOperation* operation)
+  {
+    for(int i = 0; i < DATASET_RING_SLOTS; i++)
+    {
+      DataSetSlot& slot = operation->slots[i];
+      if(slot.version & 1)
+      {
+        slot.sequence = 0;
+        slot.length = 0;
+        slot.count = 0;
+        NS_NaviCommon::atomicStore(&slot.version, slot.version + 1);
+      }
+    }
+
+    reclaimReaders(operation);
+  }
+
+  /*
+   * nobody alive uses the dataset any more: no subscriber and the last
+   * publisher gone; called with the lock held
+   */
+  inline bool abandoned(DataSetOperation* operation)
+  {
+    for(int i = 0; i < DATASET_MAX_SUBSCRIBERS; i++)
+    {
+      DataSetReader& reader = operation->readers[i];
+      if(reader.active && NS_NaviCommon::processAlive(reader.pid))
+      {
+        return false;
+      }
+    }
+
+    return !NS_NaviCommon::processAlive(operation->publisher_pid);
+  }
+
+  /*
+   * check the message type of a typed publisher or subscriber against the
+   * dataset, binding it if the dataset has none yet or nobody alive uses it
+   * any more. A latched sample of another type is not handed to the new
+   * subscribers. Called with the lock held before the peer registers itself
+   */
+  inline bool bindDataSetType(DataSetOperation* operation,
+                              const NS_NaviCommon::TypeSignature& signature)
+  {
+    bool rebind = abandoned(operation);
+    if(rebind && !NS_NaviCommon::sameType(operation->type, signature))
+    {
+      operation->latched = 0;
+    }
+
+    return NS_NaviCommon::bindType(operation->type, signature, rebind);
+  }
+
+  /*
+   * wake the subscribers after a publish, called with the lock held
+   */
+  inline void notifyReaders(DataSetOperation* operation)
+  {
+    operation->req_event.notify();
+
+    for(int i = 0; i < DATASET_MAX_SUBSCRIBERS; i++)
+    {
+      DataSetReader& reader = operation->readers[i];
+      if(reader.active && reader.doorbell)
+      {
+        NS_NaviCommon::ringDoorbell(reader.doorbell);
+      }
+    }
+  }
+
+  /*
+   * whether a publisher of process pid has to write the sample into the
+   * shared segment: it is latched, or some subscriber is not reached
+   * in-process; called with the lock held
+   */
+  inline bool needsSlot(DataSetOperation* operation, uint32_t pid)
+  {
+    if(operation->latched)
+    {
+      return true;
+    }
+
+    for(int i = 0; i < DATASET_MAX_SUBSCRIBERS; i++)
+    {
+      DataSetReader& reader = operation->readers[i];
+      if(reader.active && !(reader.local && reader.pid == pid))
+      {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  /*
+   * the local subscribers of process pid got the sample at head in-process,
+   * a handshake publish does not wait for them; called with the lock held
+   */
+  inline void skipServed(DataSetOperation* operation, uint32_t pid)
+  {
+    for(int i = 0; i < DATASET_MAX_SUBSCRIBERS; i++)
+    {
+      DataSetReader& reader = operation->readers[i];
+      if(reader.active && reader.local && reader.pid == pid)
+      {
+        NS_NaviCommon::atomicStore(&reader.cursor, operation->head);
+      }
+    }
+  }
+
+  /*
+   * whether every blocking subscriber has consumed the sample at head
+   */
+  inline bool delivered(DataSetOperation* operation)
+  {
+    for(int i = 0; i < DATASET_MAX_SUBSCRIBERS; i++)
+    {
+      DataSetReader& reader = operation->readers[i];
+      if(reader.active && reader.blocking && reader.cursor != operation->head)
+      {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  /*
+   * handshake mode, wait up to timeout milliseconds until every subscriber
+   * consumed the sample, the lock on the control block is held by the caller
+   */
+  inline bool waitDelivered(
+      DataSetOperation* operation,
+      scoped_lock< NS_NaviCommon::SharedMutex >& lock, unsigned long timeout)
+  {
+    if(operation->mode == DATASET_MODE_RING)
+    {
+      return true;
+    }
+
+    uint64_t deadline = NS_NaviCommon::SharedEvent::deadline(timeout);
+    while(!delivered(operation))
+    {
+      if(!operation->rep_event.wait(lock, deadline) && !delivered(operation))
+      {
+        /*
+         * a subscriber that died is not waited for again
+         */
+        if(reclaimReaders(operation) && delivered(operation))
+        {
+          return true;
+        }
+
+        NS_NaviCommon::recordTimeout(operation->statistics);
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  /**
+   * \brief Read-only view of one serialized sample, pointing straight into
+   * the shared payload segment.
+   *
+   * In handshake mode the sample can not change while the view is being
+   * delivered. In ring mode the publisher never waits, so it may overwrite
+   * the slot under the reader, or grow the segment and move the slot away
+   * from the mapping the view points into: check intact() after reading.
+   */
+  class DataSetView
+  {
+  public:
+    DataSetView()
+        : data_(NULL), length_(0), count_(0), version_(NULL), expected_(0),
+          generation_(NULL), mapped_(0)
+    {
+    }
+
+    /**
+     * \param version version of the slot, expected the one it had before the
+     * view was made
+     * \param generation generation of the segment, mapped the one of the
+     * mapping data points into
+     */
+    DataSetView(uint8_t* data, size_t length, uint32_t count = 1,
+                const uint32_t* version = NULL, uint32_t expected = 0,
+                const uint32_t* generation = NULL, uint32_t mapped = 0)
+        : data_(data), length_(length), count_(count), version_(version),
+          expected_(expected), generation_(generation), mapped_(mapped)
+    {
+    }
+
+    const uint8_t*
+    getData() const
+    {
+      return data_;
+    }
+
+    size_t getLength() const
+    {
+      return length_;
+    }
+
+    /**
+     * \brief Number of messages serialized back to back in the view, more
+     * than one for a sample of Publisher::publishBatch()
+     */
+    uint32_t getCount() const
+    {
+      return count_;
+    }
+
+    /**
+     * \brief Input stream over the sample, for NS_NaviCommon::deserialize,
+     * NS_NaviCommon::readArrayView or the lazy view of the type
+     */
+    NS_NaviCommon::IStream getStream() const
+    {
+      return NS_NaviCommon::IStream(data_, length_);
+    }
+
+    /**
+     * \brief Whether the publisher left the sample alone so far, neither
+     * rewriting its slot nor growing the segment under it
+     */
+    bool intact() const
+    {
+      NS_NaviCommon::acquireFence();
+      return (version_ == NULL
+          || NS_NaviCommon::atomicLoad(version_) == expected_)
+          && (generation_ == NULL
+              || NS_NaviCommon::atomicLoad(generation_) == mapped_);
+    }
+
+  private:
+    uint8_t* data_;
+    size_t length_;
+    uint32_t count_;
+    const uint32_t* version_;
+    uint32_t expected_;
+    const uint32_t* generation_;
+    uint32_t mapped_;
+  };
+
+  /**
+   * \brief Sample published as a shared object, it lives in the <name>_OBJ
+   * managed segment and is shared by reference count.
+   *
+   * The publisher holds one reference while the sample sits in a slot, a
+   * subscriber takes one for the time of its callback. References are only
+   * taken under the lock of the control block and while the slot still holds
+   * the sample, the last one released destroys it. A subscriber records the
+   * samples it holds in its reader entry and releases them under the lock
+   * too, so those of a subscriber which died are released by the publisher.
+   */
+  template< typename DataType >
+  struct SharedSample: public DataType
+  {
+    template< typename Allocator >
+    SharedSample(const Allocator& allocator)
+        : DataType(allocator), refs(1)
+    {
+    }
+
+    void retain()
+    {
+      NS_NaviCommon::atomicFetchAdd(&refs, (uint32_t)1);
+    }
+
+    template< typename Segment >
+    static void release(Segment& segment, SharedSample< DataType >* sample)
+    {
+      if(NS_NaviCommon::atomicFetchAdd(&sample->refs, (uint32_t)-1) == 1)
+      {
+        segment.destroy_ptr(sample);
+      }
+    }
+
+    uint32_t refs;
+  };
+
 }
 
 #endif /* DATASET_DATASET_H_ */
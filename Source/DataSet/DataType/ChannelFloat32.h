@@ -33,10 +33,8 @@ namespace NS_DataType
     }
     ;
 
-    std::basic_string< char, std::char_traits< char >,
-        typename ContainerAllocator::template rebind< char >::other > name;
-    std::basic_string< char, std::char_traits< char >,
-        typename ContainerAllocator::template rebind< char >::other > values;
+    typename NS_NaviCommon::ContainerString< ContainerAllocator >::Type name;
+    typename NS_NaviCommon::ContainerString< ContainerAllocator >::Type values;
 
     typedef boost::shared_ptr< ChannelFloat32_< ContainerAllocator > > Ptr;
     typedef boost::shared_ptr< ChannelFloat32_< ContainerAllocator > const > ConstPtr;
@@ -209,4 +207,55 @@ namespace NS_NaviCommon
 }
 // namespace serialization
 
+namespace NS_DataType
+{
+
+  /**
+   * \brief Lazy view over a serialized ChannelFloat32, see
+   * NS_NaviCommon::MessageView
+   */
+  template< class ContainerAllocator >
+  class ChannelFloat32View_: public NS_NaviCommon::MessageView<
+      ChannelFloat32_< ContainerAllocator > >
+  {
+  public:
+    ChannelFloat32View_()
+    {
+    }
+
+    /**
+     * \brief View the channel at the position of stream, the stream is
+     * advanced past it
+     */
+    explicit ChannelFloat32View_(NS_NaviCommon::IStream& stream)
+    {
+      this->start(stream);
+      name_ = NS_NaviCommon::readArrayView< char >(stream);
+      values_ = NS_NaviCommon::readArrayView< char >(stream);
+      this->finish(stream);
+    }
+
+    std::string name() const
+    {
+      return std::string((const char*)name_.data(), name_.size());
+    }
+
+    /*
+     * values is declared a string in ChannelFloat32_, the view keeps it so
+     */
+    const NS_NaviCommon::ArrayView< char >&
+    values() const
+    {
+      return values_;
+    }
+
+  private:
+    NS_NaviCommon::ArrayView< char > name_;
+    NS_NaviCommon::ArrayView< char > values_;
+  };
+
+  typedef ChannelFloat32View_< std::allocator< void > > ChannelFloat32View;
+
+}
+
 #endif /* DATASET_DATATYPE_CHANNELFLOAT32_H_ */
@@ -22,7 +22,7 @@ namespace NS_DataType
     ;
 
     DataHeader_(const ContainerAllocator& allocator)
-        : seq(0), stamp(allocator), frame_id(allocator)
+        : seq(0), stamp(), frame_id(allocator)
     {
     }
     ;
@@ -30,8 +30,7 @@ namespace NS_DataType
     unsigned long seq;
     NS_NaviCommon::Time stamp;
 
-    std::basic_string< char, std::char_traits< char >,
-        typename ContainerAllocator::template rebind< char >::other > frame_id;
+    typename NS_NaviCommon::ContainerString< ContainerAllocator >::Type frame_id;
 
     typedef boost::shared_ptr< DataHeader_< ContainerAllocator > > Ptr;
     typedef boost::shared_ptr< DataHeader_< ContainerAllocator > const > ConstPtr;
@@ -196,4 +195,55 @@ namespace NS_NaviCommon
 
 }
 
+namespace NS_DataType
+{
+
+  /**
+   * \brief Lazy view over a serialized DataHeader, see NS_NaviCommon::MessageView
+   */
+  template< class ContainerAllocator >
+  class DataHeaderView_: public NS_NaviCommon::MessageView<
+      DataHeader_< ContainerAllocator > >
+  {
+  public:
+    DataHeaderView_()
+    {
+    }
+
+    /**
+     * \brief View the header at the position of stream, the stream is
+     * advanced past it
+     */
+    explicit DataHeaderView_(NS_NaviCommon::IStream& stream)
+    {
+      this->start(stream);
+      stream.advance(sizeof(unsigned long) + 8);
+      frame_id_ = NS_NaviCommon::readArrayView< char >(stream);
+      this->finish(stream);
+    }
+
+    unsigned long seq() const
+    {
+      return NS_NaviCommon::readField< unsigned long >(this->data_);
+    }
+
+    NS_NaviCommon::Time stamp() const
+    {
+      return NS_NaviCommon::readField< NS_NaviCommon::Time >(
+          this->data_ + sizeof(unsigned long));
+    }
+
+    std::string frame_id() const
+    {
+      return std::string((const char*)frame_id_.data(), frame_id_.size());
+    }
+
+  private:
+    NS_NaviCommon::ArrayView< char > frame_id_;
+  };
+
+  typedef DataHeaderView_< std::allocator< void > > DataHeaderView;
+
+}
+
 #endif /* _DATAHEADER_H_ */
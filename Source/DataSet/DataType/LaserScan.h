@@ -47,10 +47,10 @@ namespace NS_DataType
     float range_min;
     float range_max;
 
-    std::vector< float,
-        typename ContainerAllocator::template rebind< float >::other > ranges;
-    std::vector< float,
-        typename ContainerAllocator::template rebind< float >::other > intensities;
+    typename NS_NaviCommon::ContainerVector< float,
+        ContainerAllocator >::Type ranges;
+    typename NS_NaviCommon::ContainerVector< float,
+        ContainerAllocator >::Type intensities;
 
     typedef boost::shared_ptr< LaserScan_< ContainerAllocator > > Ptr;
     typedef boost::shared_ptr< LaserScan_< ContainerAllocator > const > ConstPtr;
@@ -271,4 +271,107 @@ namespace NS_NaviCommon
     DECLARE_ALLINONE_SERIALIZER}; // struct LaserScan_
 }
 
+namespace NS_DataType
+{
+
+  /**
+   * \brief Lazy view over a serialized LaserScan, see
+   * NS_NaviCommon::MessageView
+   */
+  template< class ContainerAllocator >
+  class LaserScanView_: public NS_NaviCommon::MessageView<
+      LaserScan_< ContainerAllocator > >
+  {
+  public:
+    LaserScanView_()
+        : params_(NULL)
+    {
+    }
+
+    /**
+     * \brief View the scan at the position of stream, the stream is advanced
+     * past it
+     */
+    explicit LaserScanView_(NS_NaviCommon::IStream& stream)
+    {
+      this->start(stream);
+      header_ = DataHeaderView_< ContainerAllocator >(stream);
+      params_ = stream.advance(7 * sizeof(float));
+      ranges_ = NS_NaviCommon::readArrayView< float >(stream);
+      intensities_ = NS_NaviCommon::readArrayView< float >(stream);
+      this->finish(stream);
+    }
+
+    const DataHeaderView_< ContainerAllocator >&
+    header() const
+    {
+      return header_;
+    }
+
+    float angle_min() const
+    {
+      return param(0);
+    }
+
+    float angle_max() const
+    {
+      return param(1);
+    }
+
+    float angle_increment() const
+    {
+      return param(2);
+    }
+
+    float time_increment() const
+    {
+      return param(3);
+    }
+
+    float scan_time() const
+    {
+      return param(4);
+    }
+
+    float range_min() const
+    {
+      return param(5);
+    }
+
+    float range_max() const
+    {
+      return param(6);
+    }
+
+    const NS_NaviCommon::ArrayView< float >&
+    ranges() const
+    {
+      return ranges_;
+    }
+
+    const NS_NaviCommon::ArrayView< float >&
+    intensities() const
+    {
+      return intensities_;
+    }
+
+  private:
+    DataHeaderView_< ContainerAllocator > header_;
+    /*
+     * the seven floats from angle_min to range_max
+     */
+    const uint8_t* params_;
+    NS_NaviCommon::ArrayView< float > ranges_;
+    NS_NaviCommon::ArrayView< float > intensities_;
+
+    float param(int index) const
+    {
+      return NS_NaviCommon::readField< float >(params_ + index * sizeof(float));
+    }
+  };
+
+  typedef LaserScanView_< std::allocator< void > > LaserScanView;
+
+}
+
 #endif /* _LASERSCAN_H_ */
@@ -107,6 +107,16 @@ namespace NS_NaviCommon
   {
   };
 
+  template< class ContainerAllocator >
+  struct IsSimple< NS_DataType::MapMetaData_< ContainerAllocator > > : TrueType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct IsSimple< NS_DataType::MapMetaData_< ContainerAllocator > const > : TrueType
+  {
+  };
+
   template< class ContainerAllocator >
   struct IsMessage< NS_DataType::MapMetaData_< ContainerAllocator > > : TrueType
   {
@@ -36,8 +36,8 @@ namespace NS_DataType
     DataHeader_< ContainerAllocator > header;
     MapMetaData_< ContainerAllocator > info;
 
-    std::vector< char,
-        typename ContainerAllocator::template rebind< char >::other > data;
+    typename NS_NaviCommon::ContainerVector< char,
+        ContainerAllocator >::Type data;
 
     typedef boost::shared_ptr< OccupancyGrid_< ContainerAllocator > > Ptr;
     typedef boost::shared_ptr< OccupancyGrid_< ContainerAllocator > const > ConstPtr;
@@ -253,4 +253,65 @@ namespace NS_NaviCommon
 }
 // namespace serialization
 
+namespace NS_DataType
+{
+
+  /**
+   * \brief Lazy view over a serialized OccupancyGrid, see
+   * NS_NaviCommon::MessageView. A subscriber looking at the header or info
+   * only never touches the cells
+   */
+  template< class ContainerAllocator >
+  class OccupancyGridView_: public NS_NaviCommon::MessageView<
+      OccupancyGrid_< ContainerAllocator > >
+  {
+  public:
+    OccupancyGridView_()
+        : info_(NULL)
+    {
+    }
+
+    /**
+     * \brief View the map at the position of stream, the stream is advanced
+     * past it
+     */
+    explicit OccupancyGridView_(NS_NaviCommon::IStream& stream)
+    {
+      this->start(stream);
+      header_ = DataHeaderView_< ContainerAllocator >(stream);
+      info_ = stream.advance(
+          NS_NaviCommon::AllInOneSerializer<
+              MapMetaData_< ContainerAllocator > >::length);
+      cells_ = NS_NaviCommon::readArrayView< char >(stream);
+      this->finish(stream);
+    }
+
+    const DataHeaderView_< ContainerAllocator >&
+    header() const
+    {
+      return header_;
+    }
+
+    MapMetaData_< ContainerAllocator > info() const
+    {
+      return NS_NaviCommon::readField< MapMetaData_< ContainerAllocator > >(
+          info_);
+    }
+
+    const NS_NaviCommon::ArrayView< char >&
+    data() const
+    {
+      return cells_;
+    }
+
+  private:
+    DataHeaderView_< ContainerAllocator > header_;
+    const uint8_t* info_;
+    NS_NaviCommon::ArrayView< char > cells_;
+  };
+
+  typedef OccupancyGridView_< std::allocator< void > > OccupancyGridView;
+
+}
+
 #endif /* DATASET_DATATYPE_OCCUPANCYGRID_H_ */
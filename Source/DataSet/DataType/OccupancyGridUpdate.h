@@ -40,8 +40,8 @@ namespace NS_DataType
     int width;
     int height;
 
-    std::vector< char,
-        typename ContainerAllocator::template rebind< char >::other > data;
+    typename NS_NaviCommon::ContainerVector< char,
+        ContainerAllocator >::Type data;
 
     typedef boost::shared_ptr< OccupancyGridUpdate_< ContainerAllocator > > Ptr;
     typedef boost::shared_ptr< OccupancyGridUpdate_< ContainerAllocator > const > ConstPtr;
@@ -93,4 +93,117 @@ namespace NS_DataType
 
 }
 
+namespace NS_NaviCommon
+{
+
+  template< class ContainerAllocator >
+  struct IsFixedSize< NS_DataType::OccupancyGridUpdate_< ContainerAllocator > > : FalseType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct IsFixedSize< NS_DataType::OccupancyGridUpdate_< ContainerAllocator > const > : FalseType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct IsMessage< NS_DataType::OccupancyGridUpdate_< ContainerAllocator > > : TrueType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct IsMessage< NS_DataType::OccupancyGridUpdate_< ContainerAllocator > const > : TrueType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct HasHeader< NS_DataType::OccupancyGridUpdate_< ContainerAllocator > > : TrueType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct HasHeader< NS_DataType::OccupancyGridUpdate_< ContainerAllocator > const > : TrueType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct MD5Sum< NS_DataType::OccupancyGridUpdate_< ContainerAllocator > >
+  {
+    static const char*
+    value()
+    {
+      return "b295be292b335c34718bd939deebe1c9";
+    }
+
+    static const char*
+    value(const NS_DataType::OccupancyGridUpdate_< ContainerAllocator >&)
+    {
+      return value();
+    }
+    static const uint64_t static_value1 = 0xb295be292b335c34ULL;
+    static const uint64_t static_value2 = 0x718bd939deebe1c9ULL;
+  };
+
+  template< class ContainerAllocator >
+  struct DataType< NS_DataType::OccupancyGridUpdate_< ContainerAllocator > >
+  {
+    static const char*
+    value()
+    {
+      return "map_msgs/OccupancyGridUpdate";
+    }
+
+    static const char*
+    value(const NS_DataType::OccupancyGridUpdate_< ContainerAllocator >&)
+    {
+      return value();
+    }
+  };
+
+  template< class ContainerAllocator >
+  struct Definition< NS_DataType::OccupancyGridUpdate_< ContainerAllocator > >
+  {
+    static const char*
+    value()
+    {
+      return "Header header\n\
+int32 x\n\
+int32 y\n\
+uint32 width\n\
+uint32 height\n\
+int8[] data\n\
+";
+    }
+
+    static const char*
+    value(const NS_DataType::OccupancyGridUpdate_< ContainerAllocator >&)
+    {
+      return value();
+    }
+  };
+
+} // namespace message_traits
+
+namespace NS_NaviCommon
+{
+
+  template< class ContainerAllocator >
+  struct Serializer< NS_DataType::OccupancyGridUpdate_< ContainerAllocator > >
+  {
+    template< typename Stream, typename T >
+    inline static void allInOne(Stream& stream, T m)
+    {
+      stream.next(m.header);
+      stream.next(m.x);
+      stream.next(m.y);
+      stream.next(m.width);
+      stream.next(m.height);
+      stream.next(m.data);
+    }
+
+    DECLARE_ALLINONE_SERIALIZER}; // struct OccupancyGridUpdate_
+
+}
+// namespace serialization
+
 #endif /* DATASET_DATATYPE_OCCUPANCYGRIDUPDATE_H_ */
@@ -38,8 +38,8 @@ namespace NS_DataType
 
     DataHeader_< ContainerAllocator > header;
 
-    typedef std::basic_string< char, std::char_traits< char >,
-        typename ContainerAllocator::template rebind< char >::other > _child_frame_id_type;
+    typedef typename NS_NaviCommon::ContainerString< ContainerAllocator >::Type
+        _child_frame_id_type;
     _child_frame_id_type child_frame_id;
 
     Pose_< ContainerAllocator > pose;
@@ -35,9 +35,8 @@ namespace NS_DataType
     ;
 
     DataHeader_< ContainerAllocator > header;
-    std::vector< PoseStamped_< ContainerAllocator >,
-        typename ContainerAllocator::template rebind<
-            PoseStamped_< ContainerAllocator > >::other > poses;
+    typename NS_NaviCommon::ContainerVector<
+        PoseStamped_< ContainerAllocator >, ContainerAllocator >::Type poses;
 
     typedef boost::shared_ptr< Path_< ContainerAllocator > > Ptr;
     typedef boost::shared_ptr< Path_< ContainerAllocator > const > ConstPtr;
@@ -96,6 +96,16 @@ namespace NS_NaviCommon
   {
   };
 
+  template< class ContainerAllocator >
+  struct IsSimple< NS_DataType::Point_< ContainerAllocator > > : TrueType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct IsSimple< NS_DataType::Point_< ContainerAllocator > const > : TrueType
+  {
+  };
+
   template< class ContainerAllocator >
   struct IsMessage< NS_DataType::Point_< ContainerAllocator > > : TrueType
   {
@@ -94,6 +94,16 @@ namespace NS_NaviCommon
   {
   };
 
+  template< class ContainerAllocator >
+  struct IsSimple< NS_DataType::Point32_< ContainerAllocator > > : TrueType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct IsSimple< NS_DataType::Point32_< ContainerAllocator > const > : TrueType
+  {
+  };
+
   template< class ContainerAllocator >
   struct IsMessage< NS_DataType::Point32_< ContainerAllocator > > : TrueType
   {
@@ -36,12 +36,10 @@ namespace NS_DataType
     ;
 
     DataHeader_< ContainerAllocator > header;
-    std::vector< Point32_< ContainerAllocator >,
-        typename ContainerAllocator::template rebind<
-            Point32_< ContainerAllocator > >::other > points;
-    std::vector< ChannelFloat32_< ContainerAllocator >,
-        typename ContainerAllocator::template rebind<
-            ChannelFloat32_< ContainerAllocator > >::other > channels;
+    typename NS_NaviCommon::ContainerVector<
+        Point32_< ContainerAllocator >, ContainerAllocator >::Type points;
+    typename NS_NaviCommon::ContainerVector<
+        ChannelFloat32_< ContainerAllocator >, ContainerAllocator >::Type channels;
 
     typedef boost::shared_ptr< PointCloud_< ContainerAllocator > > Ptr;
     typedef boost::shared_ptr< PointCloud_< ContainerAllocator > const > ConstPtr;
@@ -83,4 +81,191 @@ namespace NS_DataType
 
 }
 
+namespace NS_NaviCommon
+{
+
+  template< class ContainerAllocator >
+  struct IsFixedSize< NS_DataType::PointCloud_< ContainerAllocator > > : FalseType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct IsFixedSize< NS_DataType::PointCloud_< ContainerAllocator > const > : FalseType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct IsMessage< NS_DataType::PointCloud_< ContainerAllocator > > : TrueType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct IsMessage< NS_DataType::PointCloud_< ContainerAllocator > const > : TrueType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct HasHeader< NS_DataType::PointCloud_< ContainerAllocator > > : TrueType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct HasHeader< NS_DataType::PointCloud_< ContainerAllocator > const > : TrueType
+  {
+  };
+
+  /*
+   * no MD5Sum, the type is told apart by its name, definition and size, see
+   * TypeSignature
+   */
+  template< class ContainerAllocator >
+  struct MD5Sum< NS_DataType::PointCloud_< ContainerAllocator > >
+  {
+    static const char*
+    value()
+    {
+      return "";
+    }
+
+    static const char*
+    value(const NS_DataType::PointCloud_< ContainerAllocator >&)
+    {
+      return value();
+    }
+    static const uint64_t static_value1 = 0;
+    static const uint64_t static_value2 = 0;
+  };
+
+  template< class ContainerAllocator >
+  struct DataType< NS_DataType::PointCloud_< ContainerAllocator > >
+  {
+    static const char*
+    value()
+    {
+      return "sensor_msgs/PointCloud";
+    }
+
+    static const char*
+    value(const NS_DataType::PointCloud_< ContainerAllocator >&)
+    {
+      return value();
+    }
+  };
+
+  template< class ContainerAllocator >
+  struct Definition< NS_DataType::PointCloud_< ContainerAllocator > >
+  {
+    static const char*
+    value()
+    {
+      return "Header header\n\
+Point32[] points\n\
+ChannelFloat32[] channels\n\
+";
+    }
+
+    static const char*
+    value(const NS_DataType::PointCloud_< ContainerAllocator >&)
+    {
+      return value();
+    }
+  };
+
+}
+
+namespace NS_NaviCommon
+{
+
+  template< class ContainerAllocator >
+  struct Serializer< NS_DataType::PointCloud_< ContainerAllocator > >
+  {
+    template< typename Stream, typename T >
+    inline static void allInOne(Stream& stream, T m)
+    {
+      stream.next(m.header);
+      stream.next(m.points);
+      stream.next(m.channels);
+    }
+
+    DECLARE_ALLINONE_SERIALIZER}; // struct PointCloud_
+
+}
+
+namespace NS_DataType
+{
+
+  /**
+   * \brief Lazy view over a serialized PointCloud, see
+   * NS_NaviCommon::MessageView. The channels are only walked to find the
+   * end of the cloud, channel() finds one again when it is asked for
+   */
+  template< class ContainerAllocator >
+  class PointCloudView_: public NS_NaviCommon::MessageView<
+      PointCloud_< ContainerAllocator > >
+  {
+  public:
+    PointCloudView_()
+        : channel_count_(0), channels_(NULL)
+    {
+    }
+
+    /**
+     * \brief View the cloud at the position of stream, the stream is
+     * advanced past it
+     */
+    explicit PointCloudView_(NS_NaviCommon::IStream& stream)
+    {
+      this->start(stream);
+      header_ = DataHeaderView_< ContainerAllocator >(stream);
+      points_ = NS_NaviCommon::readArrayView< Point32_< ContainerAllocator > >(
+          stream);
+      stream.next(channel_count_);
+      channels_ = stream.getData();
+      for(uint32_t i = 0; i < channel_count_; i++)
+      {
+        ChannelFloat32View_< ContainerAllocator > skipped(stream);
+      }
+      this->finish(stream);
+    }
+
+    const DataHeaderView_< ContainerAllocator >&
+    header() const
+    {
+      return header_;
+    }
+
+    const NS_NaviCommon::ArrayView< Point32_< ContainerAllocator > >&
+    points() const
+    {
+      return points_;
+    }
+
+    uint32_t channelCount() const
+    {
+      return channel_count_;
+    }
+
+    ChannelFloat32View_< ContainerAllocator > channel(uint32_t index) const
+    {
+      NS_NaviCommon::IStream stream(
+          channels_, (uint32_t)(this->data_ + this->length_ - channels_));
+      ChannelFloat32View_< ContainerAllocator > channel(stream);
+      for(uint32_t i = 0; i < index; i++)
+      {
+        channel = ChannelFloat32View_< ContainerAllocator >(stream);
+      }
+      return channel;
+    }
+
+  private:
+    DataHeaderView_< ContainerAllocator > header_;
+    NS_NaviCommon::ArrayView< Point32_< ContainerAllocator > > points_;
+    uint32_t channel_count_;
+    uint8_t* channels_;
+  };
+
+  typedef PointCloudView_< std::allocator< void > > PointCloudView;
+
+}
+
 #endif /* _POINTCLOUD_H_ */
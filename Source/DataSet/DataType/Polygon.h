@@ -34,9 +34,8 @@ namespace NS_DataType
     }
     ;
 
-    std::vector< Point32_< ContainerAllocator >,
-        typename ContainerAllocator::template rebind<
-            Point32_< ContainerAllocator > >::other > points;
+    typename NS_NaviCommon::ContainerVector<
+        Point32_< ContainerAllocator >, ContainerAllocator >::Type points;
 
     typedef boost::shared_ptr< Polygon_< ContainerAllocator > > Ptr;
     typedef boost::shared_ptr< Polygon_< ContainerAllocator > const > ConstPtr;
@@ -72,4 +71,110 @@ namespace NS_DataType
 
 }
 
+namespace NS_NaviCommon
+{
+
+  template< class ContainerAllocator >
+  struct IsFixedSize< NS_DataType::Polygon_< ContainerAllocator > > : FalseType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct IsFixedSize< NS_DataType::Polygon_< ContainerAllocator > const > : FalseType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct IsMessage< NS_DataType::Polygon_< ContainerAllocator > > : TrueType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct IsMessage< NS_DataType::Polygon_< ContainerAllocator > const > : TrueType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct HasHeader< NS_DataType::Polygon_< ContainerAllocator > > : FalseType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct HasHeader< NS_DataType::Polygon_< ContainerAllocator > const > : FalseType
+  {
+  };
+
+  /*
+   * no MD5Sum, the type is told apart by its name, definition and size, see
+   * TypeSignature
+   */
+  template< class ContainerAllocator >
+  struct MD5Sum< NS_DataType::Polygon_< ContainerAllocator > >
+  {
+    static const char*
+    value()
+    {
+      return "";
+    }
+
+    static const char*
+    value(const NS_DataType::Polygon_< ContainerAllocator >&)
+    {
+      return value();
+    }
+    static const uint64_t static_value1 = 0;
+    static const uint64_t static_value2 = 0;
+  };
+
+  template< class ContainerAllocator >
+  struct DataType< NS_DataType::Polygon_< ContainerAllocator > >
+  {
+    static const char*
+    value()
+    {
+      return "geometry_msgs/Polygon";
+    }
+
+    static const char*
+    value(const NS_DataType::Polygon_< ContainerAllocator >&)
+    {
+      return value();
+    }
+  };
+
+  template< class ContainerAllocator >
+  struct Definition< NS_DataType::Polygon_< ContainerAllocator > >
+  {
+    static const char*
+    value()
+    {
+      return "Point32[] points\n\
+";
+    }
+
+    static const char*
+    value(const NS_DataType::Polygon_< ContainerAllocator >&)
+    {
+      return value();
+    }
+  };
+
+}
+
+namespace NS_NaviCommon
+{
+
+  template< class ContainerAllocator >
+  struct Serializer< NS_DataType::Polygon_< ContainerAllocator > >
+  {
+    template< typename Stream, typename T >
+    inline static void allInOne(Stream& stream, T m)
+    {
+      stream.next(m.points);
+    }
+
+    DECLARE_ALLINONE_SERIALIZER}; // struct Polygon_
+
+}
+
 #endif /* DATASET_DATATYPE_POLYGON_H_ */
@@ -74,4 +74,65 @@ namespace NS_DataType
 
 }
 
+namespace NS_NaviCommon
+{
+
+  /*
+   * no MD5Sum, the type is told apart by its name, definition and size, see
+   * TypeSignature
+   */
+  template< class ContainerAllocator >
+  struct MD5Sum< NS_DataType::PolygonStamped_< ContainerAllocator > >
+  {
+    static const char*
+    value()
+    {
+      return "";
+    }
+
+    static const char*
+    value(const NS_DataType::PolygonStamped_< ContainerAllocator >&)
+    {
+      return value();
+    }
+    static const uint64_t static_value1 = 0;
+    static const uint64_t static_value2 = 0;
+  };
+
+  template< class ContainerAllocator >
+  struct DataType< NS_DataType::PolygonStamped_< ContainerAllocator > >
+  {
+    static const char*
+    value()
+    {
+      return "geometry_msgs/PolygonStamped";
+    }
+
+    static const char*
+    value(const NS_DataType::PolygonStamped_< ContainerAllocator >&)
+    {
+      return value();
+    }
+  };
+
+  template< class ContainerAllocator >
+  struct Definition< NS_DataType::PolygonStamped_< ContainerAllocator > >
+  {
+    static const char*
+    value()
+    {
+      return "Header header\n\
+Polygon polygon\n\
+";
+    }
+
+    static const char*
+    value(const NS_DataType::PolygonStamped_< ContainerAllocator >&)
+    {
+      return value();
+    }
+  };
+
+}
+
 #endif /* DATASET_DATATYPE_POLYGONSTAMPED_H_ */
@@ -91,6 +91,16 @@ namespace NS_NaviCommon
   {
   };
 
+  template< class ContainerAllocator >
+  struct IsSimple< NS_DataType::Pose_< ContainerAllocator > > : TrueType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct IsSimple< NS_DataType::Pose_< ContainerAllocator > const > : TrueType
+  {
+  };
+
   template< class ContainerAllocator >
   struct IsMessage< NS_DataType::Pose_< ContainerAllocator > > : TrueType
   {
@@ -70,4 +70,114 @@ namespace NS_DataType
 
 }
 
+namespace NS_NaviCommon
+{
+
+  template< class ContainerAllocator >
+  struct IsFixedSize< NS_DataType::PoseWithCovarianceStamped_< ContainerAllocator > > : FalseType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct IsFixedSize< NS_DataType::PoseWithCovarianceStamped_< ContainerAllocator > const > : FalseType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct IsMessage< NS_DataType::PoseWithCovarianceStamped_< ContainerAllocator > > : TrueType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct IsMessage< NS_DataType::PoseWithCovarianceStamped_< ContainerAllocator > const > : TrueType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct HasHeader< NS_DataType::PoseWithCovarianceStamped_< ContainerAllocator > > : TrueType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct HasHeader< NS_DataType::PoseWithCovarianceStamped_< ContainerAllocator > const > : TrueType
+  {
+  };
+
+  /*
+   * no MD5Sum, the type is told apart by its name, definition and size, see
+   * TypeSignature
+   */
+  template< class ContainerAllocator >
+  struct MD5Sum< NS_DataType::PoseWithCovarianceStamped_< ContainerAllocator > >
+  {
+    static const char*
+    value()
+    {
+      return "";
+    }
+
+    static const char*
+    value(const NS_DataType::PoseWithCovarianceStamped_< ContainerAllocator >&)
+    {
+      return value();
+    }
+    static const uint64_t static_value1 = 0;
+    static const uint64_t static_value2 = 0;
+  };
+
+  template< class ContainerAllocator >
+  struct DataType< NS_DataType::PoseWithCovarianceStamped_< ContainerAllocator > >
+  {
+    static const char*
+    value()
+    {
+      return "geometry_msgs/PoseWithCovarianceStamped";
+    }
+
+    static const char*
+    value(const NS_DataType::PoseWithCovarianceStamped_< ContainerAllocator >&)
+    {
+      return value();
+    }
+  };
+
+  template< class ContainerAllocator >
+  struct Definition< NS_DataType::PoseWithCovarianceStamped_< ContainerAllocator > >
+  {
+    static const char*
+    value()
+    {
+      return "Header header\n\
+Pose pose\n\
+float64[36] covariance\n\
+";
+    }
+
+    static const char*
+    value(const NS_DataType::PoseWithCovarianceStamped_< ContainerAllocator >&)
+    {
+      return value();
+    }
+  };
+
+}
+
+namespace NS_NaviCommon
+{
+
+  template< class ContainerAllocator >
+  struct Serializer< NS_DataType::PoseWithCovarianceStamped_< ContainerAllocator > >
+  {
+    template< typename Stream, typename T >
+    inline static void allInOne(Stream& stream, T m)
+    {
+      stream.next(m.header);
+      stream.next(m.pose);
+      stream.next(m.covariance);
+    }
+
+    DECLARE_ALLINONE_SERIALIZER}; // struct PoseWithCovarianceStamped_
+
+}
+
 #endif /* _DATATYPE_POSEWITHCOVARIANCESTAMPED_H_ */
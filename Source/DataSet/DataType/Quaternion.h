@@ -99,6 +99,16 @@ namespace NS_NaviCommon
   {
   };
 
+  template< class ContainerAllocator >
+  struct IsSimple< NS_DataType::Quaternion_< ContainerAllocator > > : TrueType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct IsSimple< NS_DataType::Quaternion_< ContainerAllocator > const > : TrueType
+  {
+  };
+
   template< class ContainerAllocator >
   struct IsMessage< NS_DataType::Quaternion_< ContainerAllocator > > : TrueType
   {
@@ -0,0 +1,264 @@
+/*
+ * SharedDataTypes.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: root
+ */
+
+#ifndef _DATATYPE_SHAREDDATATYPES_H_
+#define _DATATYPE_SHAREDDATATYPES_H_
+
+#include <vector>
+#include <boost/interprocess/managed_shared_memory.hpp>
+#include <boost/interprocess/mem_algo/rbtree_best_fit.hpp>
+#include <boost/interprocess/indexes/iset_index.hpp>
+#include <boost/interprocess/allocators/allocator.hpp>
+#include <boost/interprocess/containers/vector.hpp>
+#include <boost/interprocess/containers/string.hpp>
+#include "../../Common/ContainerTraits.h"
+#include "../../Thread/SharedMutex.h"
+#include "../../Serialization/Serialization.h"
+
+namespace NS_NaviCommon
+{
+
+  /*
+   * the std containers do not carry the offset_ptr of a segment allocator
+   * everywhere, fields of the shared data types use the boost.interprocess
+   * containers instead
+   */
+  template< typename T, typename U, class SegmentManager >
+  struct ContainerVector< T,
+      boost::interprocess::allocator< U, SegmentManager > >
+  {
+    typedef boost::interprocess::vector< T,
+        boost::interprocess::allocator< T, SegmentManager > > Type;
+  };
+
+  template< typename U, class SegmentManager >
+  struct ContainerString< boost::interprocess::allocator< U, SegmentManager > >
+  {
+    typedef boost::interprocess::basic_string< char, std::char_traits< char >,
+        boost::interprocess::allocator< char, SegmentManager > > Type;
+  };
+
+  /**
+   * \brief The segment allocator has no default constructor, the elements of
+   * a deserialized vector are built with the allocator of the vector
+   */
+  template< typename T, class SegmentManager >
+  struct VectorResize<
+      boost::interprocess::vector< T,
+          boost::interprocess::allocator< T, SegmentManager > > >
+  {
+    typedef boost::interprocess::vector< T,
+        boost::interprocess::allocator< T, SegmentManager > > VecType;
+
+    inline static void resize(VecType& v, uint32_t len)
+    {
+      if(len <= v.size())
+      {
+        v.erase(v.begin() + len, v.end());
+        return;
+      }
+
+      v.reserve(len);
+      while(v.size() < len)
+      {
+        v.emplace_back(v.get_allocator());
+      }
+    }
+  };
+
+  /**
+   * \brief Serializer specialized for boost.interprocess strings
+   */
+  template< class SegmentManager >
+  struct Serializer<
+      boost::interprocess::basic_string< char, std::char_traits< char >,
+          boost::interprocess::allocator< char, SegmentManager > > >
+  {
+    typedef boost::interprocess::basic_string< char, std::char_traits< char >,
+        boost::interprocess::allocator< char, SegmentManager > > StringType;
+
+    template< typename Stream >
+    inline static void write(Stream& stream, const StringType& str)
+    {
+      size_t len = str.size();
+      stream.next((uint32_t)len);
+
+      if(len > 0)
+      {
+        memcpy(stream.advance((uint32_t)len), str.data(), len);
+      }
+    }
+
+    template< typename Stream >
+    inline static void read(Stream& stream, StringType& str)
+    {
+      uint32_t len;
+      stream.next(len);
+      if(len > 0)
+      {
+        const char* data = (const char*)stream.advance(len);
+        str.assign(data, data + len);
+      }
+      else
+      {
+        str.clear();
+      }
+    }
+
+    inline static uint32_t serializedLength(const StringType& str)
+    {
+      return 4 + (uint32_t)str.size();
+    }
+  };
+
+  /**
+   * \brief Serializer specialized for boost.interprocess vectors
+   */
+  template< typename T, class SegmentManager >
+  struct Serializer<
+      boost::interprocess::vector< T,
+          boost::interprocess::allocator< T, SegmentManager > > >
+  {
+    typedef boost::interprocess::allocator< T, SegmentManager > AllocatorType;
+    typedef boost::interprocess::vector< T, AllocatorType > VecType;
+
+    template< typename Stream >
+    inline static void write(Stream& stream, const VecType& v)
+    {
+      VectorSerializer< T, AllocatorType >::write(stream, v);
+    }
+
+    template< typename Stream >
+    inline static void read(Stream& stream, VecType& v)
+    {
+      VectorSerializer< T, AllocatorType >::read(stream, v);
+    }
+
+    inline static uint32_t serializedLength(const VecType& v)
+    {
+      return VectorSerializer< T, AllocatorType >::serializedLength(v);
+    }
+  };
+
+}
+#include "ChannelFloat32.h"
+#include "DataHeader.h"
+#include "LaserScan.h"
+#include "MapMetaData.h"
+#include "OccupancyGrid.h"
+#include "OccupancyGridUpdate.h"
+#include "Odometry.h"
+#include "Path.h"
+#include "Point.h"
+#include "Point32.h"
+#include "PointCloud.h"
+#include "PointStamped.h"
+#include "Polygon.h"
+#include "PolygonStamped.h"
+#include "Pose.h"
+#include "PoseStamped.h"
+#include "PoseWithCovarianceStamped.h"
+#include "Position2DInt.h"
+#include "Quaternion.h"
+#include "QuaternionStamped.h"
+#include "Transform.h"
+#include "TransformData.h"
+#include "TransformStamped.h"
+#include "Twist.h"
+#include "TwistStamped.h"
+#include "Vector3.h"
+#include "Vector3Stamped.h"
+
+namespace NS_DataType
+{
+
+  /*
+   * the allocator of a managed segment takes a process shared mutex, which
+   * stays locked for ever when a process dies allocating or freeing; the
+   * shared data types live in a segment whose allocator takes the robust
+   * SharedMutex instead. Memory being handed out by the dead process may be
+   * lost then, but nobody hangs
+   */
+  struct SharedMutexFamily
+  {
+    typedef NS_NaviCommon::SharedMutex mutex_type;
+    typedef NS_NaviCommon::SharedRecursiveMutex recursive_mutex_type;
+  };
+
+  typedef boost::interprocess::basic_managed_shared_memory< char,
+      boost::interprocess::rbtree_best_fit< SharedMutexFamily >,
+      boost::interprocess::iset_index > SharedObjectSegment;
+
+  /*
+   * Instances of the data types which live in a boost.interprocess managed
+   * segment, every container of them allocates from the segment and points
+   * through offset_ptr, so a process mapping the segment at another address
+   * reads them as they are. Elements of their vectors are built with the
+   * segment allocator as well, e.g.
+   * path.poses.emplace_back(path.poses.get_allocator()). They are built with the allocator of the
+   * segment, e.g. segment.construct< SharedLaserScan >(anonymous_instance)(
+   * SharedAllocator(segment.get_segment_manager())), where segment is a
+   * SharedObjectSegment.
+   */
+  typedef SharedObjectSegment::segment_manager SharedSegmentManager;
+  typedef boost::interprocess::allocator< void, SharedSegmentManager >
+      SharedAllocator;
+
+  typedef ChannelFloat32_< SharedAllocator > SharedChannelFloat32;
+  typedef DataHeader_< SharedAllocator > SharedDataHeader;
+  typedef LaserScan_< SharedAllocator > SharedLaserScan;
+  typedef MapMetaData_< SharedAllocator > SharedMapMetaData;
+  typedef OccupancyGrid_< SharedAllocator > SharedOccupancyGrid;
+  typedef OccupancyGridUpdate_< SharedAllocator > SharedOccupancyGridUpdate;
+  typedef Odometry_< SharedAllocator > SharedOdometry;
+  typedef Path_< SharedAllocator > SharedPath;
+  typedef Point_< SharedAllocator > SharedPoint;
+  typedef Point32_< SharedAllocator > SharedPoint32;
+  typedef PointCloud_< SharedAllocator > SharedPointCloud;
+  typedef PointStamped_< SharedAllocator > SharedPointStamped;
+  typedef Polygon_< SharedAllocator > SharedPolygon;
+  typedef PolygonStamped_< SharedAllocator > SharedPolygonStamped;
+  typedef Pose_< SharedAllocator > SharedPose;
+  typedef PoseStamped_< SharedAllocator > SharedPoseStamped;
+  typedef PoseWithCovarianceStamped_< SharedAllocator >
+      SharedPoseWithCovarianceStamped;
+  typedef Position2DInt_< SharedAllocator > SharedPosition2DInt;
+  typedef Quaternion_< SharedAllocator > SharedQuaternion;
+  typedef QuaternionStamped_< SharedAllocator > SharedQuaternionStamped;
+  typedef Transform_< SharedAllocator > SharedTransform;
+  typedef TransformData_< SharedAllocator > SharedTransformData;
+  typedef TransformStamped_< SharedAllocator > SharedTransformStamped;
+  typedef Twist_< SharedAllocator > SharedTwist;
+  typedef TwistStamped_< SharedAllocator > SharedTwistStamped;
+  typedef Vector3_< SharedAllocator > SharedVector3;
+  typedef Vector3Stamped_< SharedAllocator > SharedVector3Stamped;
+
+  /**
+   * \brief Copy a sample between two instances of the same data type with
+   * different allocators, e.g. from LaserScan into SharedLaserScan. The
+   * elements of the vectors of a shared destination are built with its
+   * segment allocator.
+   */
+  template< typename To, typename From >
+  void copyDataType(const From& from, To& to)
+  {
+    std::vector< uint8_t > buffer(NS_NaviCommon::serializationLength(from));
+    if(buffer.empty())
+    {
+      return;
+    }
+
+    NS_NaviCommon::OStream ostream(&buffer.front(), buffer.size());
+    NS_NaviCommon::serialize(ostream, from);
+
+    NS_NaviCommon::IStream istream(&buffer.front(), buffer.size());
+    NS_NaviCommon::deserialize(istream, to);
+  }
+
+}
+
+#endif /* _DATATYPE_SHAREDDATATYPES_H_ */
@@ -33,9 +33,8 @@ namespace NS_DataType
     }
     ;
 
-    std::vector< TransformStamped_< ContainerAllocator >,
-        typename ContainerAllocator::template rebind<
-            TransformStamped_< ContainerAllocator > >::other > transforms;
+    typename NS_NaviCommon::ContainerVector<
+        TransformStamped_< ContainerAllocator >, ContainerAllocator >::Type transforms;
 
     typedef boost::shared_ptr< TransformData_< ContainerAllocator > > Ptr;
     typedef boost::shared_ptr< TransformData_< ContainerAllocator > const > ConstPtr;
@@ -71,4 +70,64 @@ namespace NS_DataType
 
 }
 
+namespace NS_NaviCommon
+{
+
+  /*
+   * no MD5Sum, the type is told apart by its name, definition and size, see
+   * TypeSignature
+   */
+  template< class ContainerAllocator >
+  struct MD5Sum< NS_DataType::TransformData_< ContainerAllocator > >
+  {
+    static const char*
+    value()
+    {
+      return "";
+    }
+
+    static const char*
+    value(const NS_DataType::TransformData_< ContainerAllocator >&)
+    {
+      return value();
+    }
+    static const uint64_t static_value1 = 0;
+    static const uint64_t static_value2 = 0;
+  };
+
+  template< class ContainerAllocator >
+  struct DataType< NS_DataType::TransformData_< ContainerAllocator > >
+  {
+    static const char*
+    value()
+    {
+      return "TransformData";
+    }
+
+    static const char*
+    value(const NS_DataType::TransformData_< ContainerAllocator >&)
+    {
+      return value();
+    }
+  };
+
+  template< class ContainerAllocator >
+  struct Definition< NS_DataType::TransformData_< ContainerAllocator > >
+  {
+    static const char*
+    value()
+    {
+      return "TransformStamped[] transforms\n\
+";
+    }
+
+    static const char*
+    value(const NS_DataType::TransformData_< ContainerAllocator >&)
+    {
+      return value();
+    }
+  };
+
+}
+
 #endif /* DATASET_DATATYPE_TRANSFORMDATA_H_ */
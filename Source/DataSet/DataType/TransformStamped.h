@@ -35,8 +35,7 @@ namespace NS_DataType
 
     DataHeader_< ContainerAllocator > header;
 
-    std::basic_string< char, std::char_traits< char >,
-        typename ContainerAllocator::template rebind< char >::other > child_frame_id;
+    typename NS_NaviCommon::ContainerString< ContainerAllocator >::Type child_frame_id;
 
     Transform_< ContainerAllocator > transform;
 
@@ -80,4 +79,110 @@ namespace NS_DataType
 
 }
 
+namespace NS_NaviCommon
+{
+
+  template< class ContainerAllocator >
+  struct IsFixedSize< NS_DataType::TransformStamped_< ContainerAllocator > > : FalseType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct IsFixedSize< NS_DataType::TransformStamped_< ContainerAllocator > const > : FalseType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct IsMessage< NS_DataType::TransformStamped_< ContainerAllocator > > : TrueType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct IsMessage< NS_DataType::TransformStamped_< ContainerAllocator > const > : TrueType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct HasHeader< NS_DataType::TransformStamped_< ContainerAllocator > > : TrueType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct HasHeader< NS_DataType::TransformStamped_< ContainerAllocator > const > : TrueType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct MD5Sum< NS_DataType::TransformStamped_< ContainerAllocator > >
+  {
+    static const char*
+    value()
+    {
+      return "b5764a33bfeb3588febc2682852579b0";
+    }
+
+    static const char*
+    value(const NS_DataType::TransformStamped_< ContainerAllocator >&)
+    {
+      return value();
+    }
+    static const uint64_t static_value1 = 0xb5764a33bfeb3588ULL;
+    static const uint64_t static_value2 = 0xfebc2682852579b0ULL;
+  };
+
+  template< class ContainerAllocator >
+  struct DataType< NS_DataType::TransformStamped_< ContainerAllocator > >
+  {
+    static const char*
+    value()
+    {
+      return "geometry_msgs/TransformStamped";
+    }
+
+    static const char*
+    value(const NS_DataType::TransformStamped_< ContainerAllocator >&)
+    {
+      return value();
+    }
+  };
+
+  template< class ContainerAllocator >
+  struct Definition< NS_DataType::TransformStamped_< ContainerAllocator > >
+  {
+    static const char*
+    value()
+    {
+      return "Header header\n\
+string child_frame_id\n\
+Transform transform\n\
+";
+    }
+
+    static const char*
+    value(const NS_DataType::TransformStamped_< ContainerAllocator >&)
+    {
+      return value();
+    }
+  };
+
+} // namespace NS_NaviCommon
+
+namespace NS_NaviCommon
+{
+
+  template< class ContainerAllocator >
+  struct Serializer< NS_DataType::TransformStamped_< ContainerAllocator > >
+  {
+    template< typename Stream, typename T >
+    inline static void allInOne(Stream& stream, T m)
+    {
+      stream.next(m.header);
+      stream.next(m.child_frame_id);
+      stream.next(m.transform);
+    }
+
+    DECLARE_ALLINONE_SERIALIZER}; // struct TransformStamped_
+
+} // namespace NS_NaviCommon
+
 #endif /* _TRANSFORMSTAMPED_H_ */
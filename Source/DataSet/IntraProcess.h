@@ -0,0 +1,280 @@
+/*
+ * IntraProcess.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: root
+ */
+
+#ifndef _DATASET_INTRA_PROCESS_H_
+#define _DATASET_INTRA_PROCESS_H_
+
+#include <map>
+#include <string>
+#include <vector>
+#include <typeinfo>
+#include <boost/shared_ptr.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/function.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include "../Callbacks/CallbackQueue.h"
+#include "../Callbacks/Spinner.h"
+
+namespace NS_DataSet
+{
+
+  /**
+   * \brief Subscriber end of the in-process path of a dataset.
+   *
+   * A typed subscriber registers one link under the name of its dataset, a
+   * publisher of the same process hands its samples to the links instead of
+   * serializing them into the shared segment. The callback lock serializes
+   * the callbacks of the subscriber, whichever thread they come from.
+   *
+   * Without a callback queue the link has a queue and a delivery thread of
+   * its own, so the callbacks never run in the publishing thread unless the
+   * subscriber asked for synchronous delivery.
+   */
+  class IntraProcessLink
+  {
+  public:
+    IntraProcessLink(const std::type_info& type,
+                     NS_NaviCommon::CallbackQueueInterface* queue,
+                     bool synchronous)
+        : type_(type), queue_(queue), synchronous_(synchronous),
+          attached_(true)
+    {
+    }
+
+    virtual ~IntraProcessLink()
+    {
+    }
+
+    const std::type_info&
+    type() const
+    {
+      return type_;
+    }
+
+    /*
+     * whether the subscriber was given a callback queue
+     */
+    bool queued() const
+    {
+      return queue_ != NULL;
+    }
+
+    /*
+     * called by the subscriber before it registers the link, starts the
+     * delivery thread unless the samples go through the queue of the
+     * subscriber or run in the publishing thread
+     */
+    void open()
+    {
+      if(!queue_ && !synchronous_)
+      {
+        own_queue_.reset(new NS_NaviCommon::CallbackQueue);
+        queue_ = own_queue_.get();
+        delivery_thread_ = boost::thread(
+            boost::bind(&IntraProcessLink::deliverQueued, own_queue_.get()));
+      }
+    }
+
+    boost::mutex&
+    callbackLock()
+    {
+      return callback_lock_;
+    }
+
+    /**
+     * \brief Stop delivering, waits for a callback in progress and drops the
+     * samples still queued. The subscriber calls it before it goes away
+     */
+    void detach()
+    {
+      {
+        boost::mutex::scoped_lock lock(callback_lock_);
+        attached_ = false;
+      }
+
+      if(queue_)
+      {
+        queue_->removeByID((unsigned long)this);
+      }
+
+      if(own_queue_)
+      {
+        own_queue_->disable();
+        delivery_thread_.join();
+      }
+    }
+
+  protected:
+    const std::type_info& type_;
+    NS_NaviCommon::CallbackQueueInterface* queue_;
+    bool synchronous_;
+    boost::mutex callback_lock_;
+    bool attached_;
+
+  private:
+    boost::scoped_ptr< NS_NaviCommon::CallbackQueue > own_queue_;
+    boost::thread delivery_thread_;
+
+    static void deliverQueued(NS_NaviCommon::CallbackQueue* queue)
+    {
+      NS_NaviCommon::SingleThreadedSpinner spinner;
+      spinner.spin(queue);
+    }
+  };
+
+  typedef boost::shared_ptr< IntraProcessLink > IntraProcessLinkPtr;
+
+  /**
+   * \brief Link of a subscriber of DataType. Samples arrive as batches of
+   * shared pointers, one sample for publish() and all of them for
+   * publishBatch(); they are shared with the publisher and every other
+   * subscriber of the process, so the handler must not change them.
+   */
+  template< typename DataType >
+  class IntraProcessReceiver: public IntraProcessLink
+  {
+  public:
+    typedef boost::shared_ptr< const DataType > SamplePtr;
+    typedef std::vector< SamplePtr > Batch;
+    typedef boost::function< void(const Batch&) > Handler;
+
+    IntraProcessReceiver(const Handler& handler,
+                         NS_NaviCommon::CallbackQueueInterface* queue,
+                         bool synchronous)
+        : IntraProcessLink(typeid(DataType), queue, synchronous),
+          handler_(handler)
+    {
+    }
+
+    /*
+     * called by the publisher, without the lock of the dataset: the batch
+     * is queued, on the queue of the subscriber or of the link, unless the
+     * subscriber asked for synchronous delivery; then the handler runs right
+     * away in the publishing thread
+     */
+    static void receive(const boost::shared_ptr< IntraProcessReceiver >& self,
+                        const Batch& batch)
+    {
+      if(self->queue_)
+      {
+        self->queue_->addCallback(
+            NS_NaviCommon::CallbackInterfacePtr(
+                new QueuedBatch(self, batch)),
+            (unsigned long)self.get());
+      }
+      else
+      {
+        self->dispatch(batch);
+      }
+    }
+
+  private:
+    Handler handler_;
+
+    void dispatch(const Batch& batch)
+    {
+      boost::mutex::scoped_lock lock(callback_lock_);
+      if(attached_)
+      {
+        handler_(batch);
+      }
+    }
+
+    class QueuedBatch: public NS_NaviCommon::CallbackInterface
+    {
+    public:
+      QueuedBatch(const boost::shared_ptr< IntraProcessReceiver >& receiver,
+                  const Batch& batch)
+          : receiver_(receiver), batch_(batch)
+      {
+      }
+
+      CallResult call()
+      {
+        receiver_->dispatch(batch_);
+        return Success;
+      }
+
+    private:
+      boost::shared_ptr< IntraProcessReceiver > receiver_;
+      Batch batch_;
+    };
+  };
+
+  /**
+   * \brief Links of the typed subscribers of this process, by dataset name.
+   *
+   * Links are added and removed, and looked up by a publisher, with the
+   * lock of the dataset held, so a sample is either handed over in-process
+   * or left in the shared segment for a subscriber, never both or neither.
+   */
+  class IntraProcessRegistry
+  {
+  public:
+    static IntraProcessRegistry&
+    instance()
+    {
+      static IntraProcessRegistry registry;
+      return registry;
+    }
+
+    void add(const std::string& name, const IntraProcessLinkPtr& link)
+    {
+      boost::mutex::scoped_lock lock(lock_);
+      links_.insert(std::make_pair(name, link));
+    }
+
+    void remove(const std::string& name, const IntraProcessLinkPtr& link)
+    {
+      boost::mutex::scoped_lock lock(lock_);
+      std::pair< LinkMap::iterator, LinkMap::iterator > range =
+          links_.equal_range(name);
+      for(LinkMap::iterator it = range.first; it != range.second; ++it)
+      {
+        if(it->second == link)
+        {
+          links_.erase(it);
+          break;
+        }
+      }
+    }
+
+    /*
+     * the links of name receiving DataType
+     */
+    template< typename DataType >
+    void find(const std::string& name,
+              std::vector< boost::shared_ptr< IntraProcessReceiver< DataType > > >& receivers)
+    {
+      receivers.clear();
+
+      boost::mutex::scoped_lock lock(lock_);
+      std::pair< LinkMap::iterator, LinkMap::iterator > range =
+          links_.equal_range(name);
+      for(LinkMap::iterator it = range.first; it != range.second; ++it)
+      {
+        if(it->second->type() == typeid(DataType))
+        {
+          receivers.push_back(
+              boost::static_pointer_cast< IntraProcessReceiver< DataType > >(
+                  it->second));
+        }
+      }
+    }
+
+  private:
+    typedef std::multimap< std::string, IntraProcessLinkPtr > LinkMap;
+
+    boost::mutex lock_;
+    LinkMap links_;
+  };
+
+}
+
+#endif /* _DATASET_INTRA_PROCESS_H_ */
@@ -12,6 +12,10 @@
 #include <boost/interprocess/mapped_region.hpp>
 #include <boost/interprocess/sync/scoped_lock.hpp>
 #include "DataSet.h"
+#include "IntraProcess.h"
+#include "../Common/SharedSegment.h"
+#include "../Thread/Atomic.h"
+#include "../Thread/RemapLock.h"
 #include "../Serialization/Serialization.h"
 
 namespace NS_DataSet
@@ -22,17 +26,37 @@ namespace NS_DataSet
   template< typename DataType >
   class Publisher
   {
+    typedef IntraProcessReceiver< DataType > Receiver;
+    typedef boost::shared_ptr< Receiver > ReceiverPtr;
+    typedef typename Receiver::Batch Batch;
   public:
-    Publisher(std::string name)
+    /**
+     * \brief Attach to a dataset.
+     * \param mode transport mode, every publisher of a dataset should use the same
+     * \param capacity_hint expected size of one message, the payload segment
+     * grows geometrically when a message does not fit
+     * \param latched keep the last sample resident, a subscriber attaching
+     * later receives it right away, e.g. for a static map
+     */
+    Publisher(std::string name, DataSetMode mode = DATASET_MODE_HANDSHAKE,
+              size_t capacity_hint = 0, bool latched = false)
     {
       dataset_name = name;
       operation = NULL;
+      signature = NS_NaviCommon::typeSignature< DataType >();
+      rejected = false;
+      transport_mode = mode;
+      latch = latched;
+      timeout = DATASET_DEFAULT_TIMEOUT;
+      min_capacity = capacity_hint;
+      pending_slot = NULL;
+      ds_segment.setName(dataset_name + "_DS");
       obtainOper();
     }
 
     virtual ~Publisher()
     {
-
+      cancelLoan();
     }
 
   private:
@@ -40,114 +64,506 @@ namespace NS_DataSet
 
     DataSetOperation* operation;
 
+    /*
+     * once the dataset turned out to carry another message type the
+     * publisher stays detached
+     */
+    NS_NaviCommon::TypeSignature signature;
+    bool rejected;
+
     mapped_region oper_region;
-    mapped_region ds_region;
+
+    NS_NaviCommon::SharedSegment ds_segment;
+    size_t min_capacity;
+
+    DataSetMode transport_mode;
+    bool latch;
+
+    unsigned long timeout;
+
+    DataSetSlot* pending_slot;
+
+    /*
+     * held shared by every publish while it uses operation and the
+     * segment, and exclusively to map them again; loan_use keeps it from
+     * loan() to publishLoaned() or cancelLoan()
+     */
+    NS_NaviCommon::RemapLock attach_lock;
+    boost::shared_lock< NS_NaviCommon::RemapLock > loan_use;
 
   private:
 
+    /*
+     * the dataset may be published before anybody subscribes to it, so the
+     * publisher creates the control block as well
+     */
     void obtainOper()
     {
-      shared_memory_object oper_shm;
-
       try
       {
-        oper_shm = shared_memory_object(open_only, dataset_name.c_str(),
-                                        read_write);
+        operation = attachOperation(dataset_name, oper_region);
       }
       catch(interprocess_exception& exception)
+      {
+        operation = NULL;
+      }
+
+      if(!operation)
       {
         return;
       }
 
-      offset_t oper_size = 0;
-      if(oper_shm.get_size(oper_size) && oper_size == sizeof(DataSetOperation))
+      scoped_lock< NS_NaviCommon::SharedMutex > lock(operation->lock);
+
+      if(!bindDataSetType(operation, signature))
+      {
+        printf("dataset %s carries %s, can not publish %s!\n",
+               dataset_name.c_str(), operation->type.name, signature.name);
+        operation = NULL;
+        rejected = true;
+        return;
+      }
+
+      operation->publisher_pid = NS_NaviCommon::currentProcess();
+    }
+
+    /*
+     * attach again if the watchdog retired the dataset while nobody else
+     * used it, subscribers starting later create a new one. Returns with use
+     * holding attach_lock, the old mapping is only dropped once no publish
+     * is using it
+     */
+    bool attached(boost::shared_lock< NS_NaviCommon::RemapLock >& use)
+    {
+      use.lock();
+      if(operation ?
+          NS_NaviCommon::atomicLoad(&operation->magic) == DATASET_MAGIC :
+          rejected)
+      {
+        return operation != NULL;
+      }
+      use.unlock();
+
+      {
+        boost::unique_lock< NS_NaviCommon::RemapLock > lock(attach_lock);
+
+        if(operation
+            && NS_NaviCommon::atomicLoad(&operation->magic) != DATASET_MAGIC)
+        {
+          operation = NULL;
+          ds_segment.unmap();
+        }
+
+        if(!operation && !rejected)
+        {
+          obtainOper();
+        }
+      }
+
+      use.lock();
+      return operation != NULL;
+    }
+
+    /*
+     * the mode is asserted on every publish, switching it changes the slot
+     * layout so every slot is invalidated
+     */
+    void applyMode()
+    {
+      if(operation->lock.recovered())
+      {
+        recoverOperation(operation);
+      }
+
+      operation->publisher_pid = NS_NaviCommon::currentProcess();
+      operation->latched = latch;
+
+      if(operation->mode != transport_mode)
       {
+        operation->mode = transport_mode;
+        invalidateSlots();
+      }
+    }
+
+    void invalidateSlots()
+    {
+      openSlots();
+      closeSlots(true);
+    }
 
-        oper_region = mapped_region(oper_shm, read_write);
+    /*
+     * mark every slot as being written, a reader drops what it reads from
+     * them until closeSlots()
+     */
+    void openSlots()
+    {
+      for(int i = 0; i < DATASET_RING_SLOTS; i++)
+      {
+        DataSetSlot& slot = operation->slots[i];
+        NS_NaviCommon::atomicStore(&slot.version, slot.version + 1);
+      }
+      NS_NaviCommon::releaseFence();
+    }
 
-        void* region_addr = oper_region.get_address();
-        if(region_addr)
+    void closeSlots(bool clear)
+    {
+      for(int i = 0; i < DATASET_RING_SLOTS; i++)
+      {
+        DataSetSlot& slot = operation->slots[i];
+        if(clear)
         {
-          operation = static_cast< DataSetOperation* >(region_addr);
-          operation->status = DATASET_IDLE;
+          slot.sequence = 0;
+          slot.length = 0;
         }
+        NS_NaviCommon::atomicStore(&slot.version, slot.version + 1);
       }
     }
 
-    void*
-    getSrv()
+    /*
+     * reserve the next slot for length bytes and start rewriting it, the
+     * lock must be held until commitSlot() or abortSlot(). A length of 0
+     * takes the slot as it is, at least the segment gets mapped
+     */
+    uint8_t*
+    beginSlot(size_t length)
     {
-      std::string ds_shm_name = dataset_name + "_DS";
+      uint32_t count = slotCount(transport_mode);
+      size_t size = length ? length * count : 1;
+
+      /*
+       * the slots move when the segment grows. They are all opened before
+       * the new capacity and generation are published, otherwise a reader
+       * mapping the grown segment would still take the old ones for valid
+       * and read them at their new offsets
+       */
+      bool grows = size > operation->capacity;
+      if(grows)
+      {
+        openSlots();
+      }
+
+      uint32_t generation = operation->generation;
+      bool reserved = ds_segment.reserve(size, operation->capacity,
+                                         operation->generation,
+                                         min_capacity * count);
+
+      if(grows)
+      {
+        closeSlots(operation->generation != generation);
+      }
+
+      if(!reserved)
+      {
+        return NULL;
+      }
+
+      size_t slot_capacity = ds_segment.getCapacity() / count;
+      uint32_t sequence = operation->head + 1;
+      uint32_t index = sequence % count;
+      DataSetSlot& slot = operation->slots[index];
 
-      shared_memory_object ds_shm(open_only, ds_shm_name.c_str(), read_write);
+      NS_NaviCommon::atomicStore(&slot.version, slot.version + 1);
+      NS_NaviCommon::releaseFence();
 
-      ds_region = mapped_region(ds_shm, read_write);
+      slot.sequence = sequence;
+      slot.length = length;
+      slot.count = 1;
+      slot.served = 0;
 
-      void* region_addr = ds_region.get_address();
+      pending_slot = &slot;
 
-      return region_addr;
+      return ds_segment.getAddress() + index * slot_capacity;
     }
 
-    void resize(size_t size)
+    /*
+     * publish the slot opened by beginSlot(), advance head and wake every
+     * subscriber
+     */
+    void commitSlot()
     {
-      std::string srv_shm_name = dataset_name + "_DS";
+      DataSetSlot& slot = *pending_slot;
+      pending_slot = NULL;
 
-      shared_memory_object::remove(srv_shm_name.c_str());
+      slot.stamp = NS_NaviCommon::SharedEvent::now();
 
-      shared_memory_object srv_shm(create_only, srv_shm_name.c_str(),
-                                   read_write);
+      NS_NaviCommon::atomicStore(&slot.version, slot.version + 1);
+      NS_NaviCommon::atomicStore(&operation->head, slot.sequence);
+
+      if(slot.served)
+      {
+        skipServed(operation, slot.served);
+      }
 
-      srv_shm.truncate(size);
+      NS_NaviCommon::recordPublish(operation->statistics, slot.count);
+      NS_NaviCommon::recordTransfer(operation->statistics, slot.length);
 
-      operation->buf_len = size;
+      notifyReaders(operation);
     }
 
-  public:
-    bool publish(DataType& ds)
+    void abortSlot()
     {
-      if(!operation)
+      DataSetSlot& slot = *pending_slot;
+      pending_slot = NULL;
+
+      slot.sequence = 0;
+      slot.length = 0;
+      slot.count = 0;
+      NS_NaviCommon::atomicStore(&slot.version, slot.version + 1);
+    }
+
+    /*
+     * the subscribers of this process get the messages in-process, as the
+     * shared pointers of batch or as copies when it is empty. The shared
+     * segment is only written for the others, and for a latched dataset
+     */
+    template< typename Iterator >
+    bool publishRange(Iterator first, Iterator last, Batch& batch)
+    {
+      boost::shared_lock< NS_NaviCommon::RemapLock > use(
+          attach_lock, boost::defer_lock);
+      if(!attached(use))
       {
-        obtainOper();
-        if(!operation)
+        return false;
+      }
+
+      DataSetOperation* published = operation;
+
+      scoped_lock< NS_NaviCommon::SharedMutex > lock(operation->lock);
+
+      applyMode();
+
+      uint32_t count = 0;
+      for(Iterator it = first; it != last; ++it)
+      {
+        count++;
+      }
+
+      std::vector< ReceiverPtr > receivers;
+      IntraProcessRegistry::instance().find(dataset_name, receivers);
+
+      if(!receivers.empty() && batch.empty())
+      {
+        batch.reserve(count);
+        for(Iterator it = first; it != last; ++it)
         {
-          return false;
+          batch.push_back(
+              typename Receiver::SamplePtr(new DataType(*it)));
         }
       }
 
-      scoped_lock< interprocess_mutex > lock(operation->lock);
+      uint32_t pid = NS_NaviCommon::currentProcess();
+      bool slot = needsSlot(operation, pid);
+      if(slot)
+      {
+        /*
+         * serialized straight into the slot in one pass; only when the
+         * samples outgrow it the segment grows and they are copied over
+         */
+        uint8_t* addr = beginSlot(0);
+        if(!addr)
+        {
+          return false;
+        }
 
-      operation->buf_len = NS_NaviCommon::serializationLength(ds);
+        NS_NaviCommon::GrowableOStream stream(
+            addr, ds_segment.getCapacity() / slotCount(transport_mode));
+        for(Iterator it = first; it != last; ++it)
+        {
+          NS_NaviCommon::serialize(stream, *it);
+        }
+
+        if(stream.spilled())
+        {
+          abortSlot();
+
+          addr = beginSlot(stream.size());
+          if(!addr)
+          {
+            return false;
+          }
 
-      resize(operation->buf_len);
+          memcpy(addr, stream.data(), stream.size());
+        }
+
+        pending_slot->length = stream.size();
+        pending_slot->count = count;
+        pending_slot->served = pid;
+
+        commitSlot();
+      }
+      else
+      {
+        NS_NaviCommon::recordPublish(operation->statistics, count);
+      }
 
-      unsigned char* addr = (unsigned char*)getSrv();
+      if(receivers.empty())
+      {
+        return !slot || waitDelivered(operation, lock, timeout);
+      }
 
-      NS_NaviCommon::OStream stream(addr, operation->buf_len);
-      NS_NaviCommon::serialize(stream, ds);
+      /*
+       * callbacks run without the locks, they may publish themselves. The
+       * dataset may be attached again meanwhile, what was published to the
+       * retired one is left alone then
+       */
+      uint64_t stamp = NS_NaviCommon::SharedEvent::now();
 
-      operation->status = DATASET_PROCESSING;
-      operation->req_cond.notify_all();
+      lock.unlock();
+      use.unlock();
 
-      int try_times = 10;
-      bool timeout = false;
-      while(operation->status == DATASET_PROCESSING)
+      for(size_t i = 0; i < receivers.size(); i++)
       {
-        operation->req_cond.timed_wait(
-            lock,
-            (boost::get_system_time() + boost::posix_time::microseconds(100)));
-        if(try_times-- < 0)
+        Receiver::receive(receivers[i], batch);
+
+        use.lock();
+        if(operation == published)
         {
-          timeout = true;
-          break;
+          NS_NaviCommon::recordDelivery(operation->statistics, stamp, count);
         }
+        use.unlock();
       }
 
-      if(timeout)
+      if(!slot)
+      {
+        return true;
+      }
+
+      use.lock();
+      if(operation != published)
+      {
+        return true;
+      }
+      lock.lock();
+
+      return waitDelivered(operation, lock, timeout);
+    }
+
+  public:
+    /**
+     * \brief Time in milliseconds a handshake publish waits for the
+     * subscribers before it gives up, SharedEvent::INFINITE_WAIT to wait for
+     * ever
+     */
+    void setTimeout(unsigned long milliseconds)
+    {
+      timeout = milliseconds;
+    }
+
+    /**
+     * \brief Publish a sample. The subscribers of this process get it
+     * in-process, through a copy shared among them; the others get it
+     * serialized into the shared segment, which is skipped altogether when
+     * there are none and the dataset is not latched.
+     */
+    bool publish(DataType& ds)
+    {
+      Batch batch;
+      return publishRange(&ds, &ds + 1, batch);
+    }
+
+    /**
+     * \brief Publish a sample the subscribers of this process share with
+     * the publisher: they get the pointer itself, nothing is copied, so the
+     * sample must not be changed any more. Subscribers in other processes
+     * get it serialized as usual.
+     */
+    bool publish(const boost::shared_ptr< const DataType >& ds)
+    {
+      Batch batch(1, ds);
+      return publishRange(ds.get(), ds.get() + 1, batch);
+    }
+
+    /**
+     * \brief Publish the messages of [first, last) as one sample: they are
+     * serialized back to back into a single slot under one lock and the
+     * subscribers are woken once. Subscriber calls its callback for each of
+     * them in turn, BatchSubscriber once for all of them.
+     */
+    template< typename Iterator >
+    bool publishBatch(Iterator first, Iterator last)
+    {
+      if(first == last)
+      {
+        return true;
+      }
+
+      Batch batch;
+      return publishRange(first, last, batch);
+    }
+
+    /**
+     * \brief Loan a writable buffer of length bytes in the next slot of the
+     * shared segment, to be filled in place with the serialized sample.
+     *
+     * Write the sample through an NS_NaviCommon::OStream over the buffer, using
+     * NS_NaviCommon::writeArraySpan to fill large arrays in place, then call
+     * publishLoaned() or cancelLoan(). The dataset stays locked meanwhile.
+     * \return NULL if the dataset is not available
+     */
+    uint8_t*
+    loan(size_t length)
+    {
+      boost::shared_lock< NS_NaviCommon::RemapLock > use(
+          attach_lock, boost::defer_lock);
+      if(!attached(use))
+      {
+        return NULL;
+      }
+
+      operation->lock.lock();
+
+      applyMode();
+
+      uint8_t* addr = beginSlot(length);
+      if(!addr)
+      {
+        operation->lock.unlock();
+        return NULL;
+      }
+
+      loan_use.swap(use);
+
+      return addr;
+    }
+
+    /**
+     * \brief Publish the buffer obtained from loan()
+     */
+    bool publishLoaned()
+    {
+      if(!pending_slot)
       {
         return false;
       }
 
-      return true;
+      bool delivered;
+      {
+        scoped_lock< NS_NaviCommon::SharedMutex > lock(operation->lock,
+                                                       accept_ownership);
+
+        commitSlot();
+
+        delivered = waitDelivered(operation, lock, timeout);
+      }
+      loan_use.unlock();
+
+      return delivered;
+    }
+
+    /**
+     * \brief Give back the buffer obtained from loan() without publishing it
+     */
+    void cancelLoan()
+    {
+      if(!pending_slot)
+      {
+        return;
+      }
+
+      abortSlot();
+
+      operation->lock.unlock();
+      loan_use.unlock();
     }
   };
 
@@ -0,0 +1,357 @@
+/*
+ * SharedPublisher.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: root
+ */
+
+#ifndef _DATASET_SHARED_PUBLISHER_H_
+#define _DATASET_SHARED_PUBLISHER_H_
+
+#include <boost/interprocess/managed_shared_memory.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+#include "DataSet.h"
+#include "DataType/SharedDataTypes.h"
+#include "../Thread/Atomic.h"
+
+namespace NS_DataSet
+{
+
+  using namespace boost::interprocess;
+
+  /**
+   * \brief Publisher of samples built directly in shared memory.
+   *
+   * DataType is one of the NS_DataType::Shared* types. Samples are allocated
+   * in the <name>_OBJ managed segment, filled in place and published by
+   * handle, so nothing is serialized or copied; SharedSubscriber hands them
+   * to its callback by reference. A dataset carries either serialized or
+   * shared samples, do not mix Publisher and SharedPublisher on one name.
+   */
+  template< typename DataType >
+  class SharedPublisher
+  {
+    typedef SharedSample< DataType > SampleType;
+  public:
+    /**
+     * \param segment_size size of the <name>_OBJ segment, it can not grow
+     * once mapped, so it has to hold every sample alive at the same time:
+     * the ones in the slots plus the ones subscribers are still reading.
+     * A segment left by peers which are all gone is created again with
+     * this size, one still in use is kept as it is
+     * \param latched keep the last sample referenced, a subscriber attaching
+     * later receives it right away
+     */
+    SharedPublisher(std::string name, size_t segment_size,
+                    DataSetMode mode = DATASET_MODE_HANDSHAKE,
+                    bool latched = false)
+    {
+      dataset_name = name;
+      operation = NULL;
+      transport_mode = mode;
+      latch = latched;
+      timeout = DATASET_DEFAULT_TIMEOUT;
+
+      try
+      {
+        operation = attachOperation(dataset_name, oper_region);
+      }
+      catch(interprocess_exception& exception)
+      {
+        operation = NULL;
+      }
+
+      if(!operation)
+      {
+        printf("create shared dataset %s fail!\n", dataset_name.c_str());
+        return;
+      }
+
+      scoped_lock< NS_NaviCommon::SharedMutex > lock(operation->lock);
+
+      if(operation->lock.recovered())
+      {
+        recoverOperation(operation);
+      }
+
+      if(!mapSegment(segment_size))
+      {
+        printf("create shared dataset %s fail!\n", dataset_name.c_str());
+        operation = NULL;
+        return;
+      }
+
+      NS_NaviCommon::TypeSignature signature =
+          NS_NaviCommon::typeSignature< DataType >(
+              NS_NaviCommon::WIRE_SHARED_OBJECT);
+      if(!bindDataSetType(operation, signature))
+      {
+        printf("dataset %s carries %s, can not publish %s!\n",
+               dataset_name.c_str(), operation->type.name, signature.name);
+        operation = NULL;
+        return;
+      }
+
+      operation->publisher_pid = NS_NaviCommon::currentProcess();
+    }
+
+    virtual ~SharedPublisher()
+    {
+    }
+
+  private:
+    std::string dataset_name;
+
+    DataSetOperation* operation;
+
+    mapped_region oper_region;
+
+    NS_DataType::SharedObjectSegment obj_segment;
+
+    DataSetMode transport_mode;
+    bool latch;
+
+    unsigned long timeout;
+
+  private:
+
+    /*
+     * map the <name>_OBJ segment, called with the lock held. When nobody
+     * alive uses the dataset no sample is in use either, the segment is
+     * created anew: it gets the size asked for and the samples leaked by
+     * peers which died are gone with it
+     */
+    bool mapSegment(size_t segment_size)
+    {
+      std::string segment_name = dataset_name + "_OBJ";
+
+      if(abandoned(operation))
+      {
+        shared_memory_object::remove(segment_name.c_str());
+        for(int i = 0; i < DATASET_RING_SLOTS; i++)
+        {
+          operation->slots[i].sequence = 0;
+          operation->slots[i].handle = 0;
+        }
+        for(int i = 0; i < DATASET_MAX_SUBSCRIBERS; i++)
+        {
+          memset(operation->readers[i].pinned, 0,
+                 sizeof(operation->readers[i].pinned));
+        }
+      }
+
+      try
+      {
+        obj_segment = NS_DataType::SharedObjectSegment(open_or_create,
+                                                       segment_name.c_str(),
+                                                       segment_size);
+      }
+      catch(interprocess_exception& exception)
+      {
+        return false;
+      }
+
+      if(obj_segment.get_size() < segment_size)
+      {
+        printf("shared dataset %s is in use with a segment of %lu bytes!\n",
+               dataset_name.c_str(), (unsigned long)obj_segment.get_size());
+      }
+
+      return true;
+    }
+
+    /*
+     * release the samples subscribers which died were holding; called with
+     * the lock held. Returns how many were released
+     */
+    int reclaimSamples()
+    {
+      uint64_t now = NS_NaviCommon::SharedEvent::now();
+      int released = 0;
+      for(int i = 0; i < DATASET_MAX_SUBSCRIBERS; i++)
+      {
+        DataSetReader& reader = operation->readers[i];
+
+        /*
+         * a subscriber shows its heartbeat at least every period, one that
+         * holds samples and was not seen for two may have died in its
+         * callback. The ones reclaimReaders() dropped are inactive already
+         */
+        if(reader.active)
+        {
+          if(!holdsSamples(reader)
+              || now - reader.heartbeat
+                  < 2000000ULL * NS_NaviCommon::HEARTBEAT_PERIOD
+              || NS_NaviCommon::processAlive(reader.pid))
+          {
+            continue;
+          }
+
+          reader.active = 0;
+          operation->rep_event.notify();
+        }
+
+        for(int j = 0; j < DATASET_RING_SLOTS; j++)
+        {
+          if(reader.pinned[j])
+          {
+            SampleType* sample = static_cast< SampleType* >(
+                obj_segment.get_address_from_handle(reader.pinned[j]));
+            reader.pinned[j] = 0;
+            SampleType::release(obj_segment, sample);
+            released++;
+          }
+        }
+      }
+
+      return released;
+    }
+
+    /*
+     * drop the reference the slot holds on its sample
+     */
+    void retireSlot(DataSetSlot& slot)
+    {
+      if(slot.handle)
+      {
+        SampleType* sample = static_cast< SampleType* >(
+            obj_segment.get_address_from_handle(slot.handle));
+        slot.handle = 0;
+        SampleType::release(obj_segment, sample);
+      }
+    }
+
+    void applyMode()
+    {
+      if(operation->lock.recovered())
+      {
+        recoverOperation(operation);
+      }
+
+      operation->publisher_pid = NS_NaviCommon::currentProcess();
+      operation->latched = latch;
+
+      if(operation->mode != transport_mode)
+      {
+        operation->mode = transport_mode;
+        for(int i = 0; i < DATASET_RING_SLOTS; i++)
+        {
+          DataSetSlot& slot = operation->slots[i];
+          NS_NaviCommon::atomicStore(&slot.version, slot.version + 1);
+          NS_NaviCommon::releaseFence();
+          slot.sequence = 0;
+          retireSlot(slot);
+          NS_NaviCommon::atomicStore(&slot.version, slot.version + 1);
+        }
+      }
+    }
+
+  public:
+    /**
+     * \brief Time in milliseconds a handshake publish waits for the
+     * subscribers before it gives up, SharedEvent::INFINITE_WAIT to wait for
+     * ever
+     */
+    void setTimeout(unsigned long milliseconds)
+    {
+      timeout = milliseconds;
+    }
+
+    /**
+     * \brief Construct a new sample in the shared segment, to be filled and
+     * passed to publish() or release().
+     * \return NULL if the segment is full or not available
+     */
+    DataType*
+    allocate()
+    {
+      if(!operation)
+      {
+        return NULL;
+      }
+
+      {
+        scoped_lock< NS_NaviCommon::SharedMutex > lock(operation->lock);
+        reclaimSamples();
+      }
+
+      for(int attempt = 0; attempt < 2; attempt++)
+      {
+        try
+        {
+          return obj_segment.construct< SampleType >(anonymous_instance)(
+              NS_DataType::SharedAllocator(obj_segment.get_segment_manager()));
+        }
+        catch(interprocess_exception& exception)
+        {
+        }
+
+        /*
+         * the segment is full, maybe of samples held by subscribers which
+         * died too recently to have missed a heartbeat
+         */
+        scoped_lock< NS_NaviCommon::SharedMutex > lock(operation->lock);
+        reclaimReaders(operation);
+        if(!reclaimSamples())
+        {
+          break;
+        }
+      }
+
+      return NULL;
+    }
+
+    /**
+     * \brief Give back a sample obtained from allocate() without publishing it
+     */
+    void release(DataType* ds)
+    {
+      SampleType::release(obj_segment, static_cast< SampleType* >(ds));
+    }
+
+    /**
+     * \brief Publish a sample obtained from allocate(), the publisher takes
+     * it over and the sample must not be modified afterwards.
+     */
+    bool publish(DataType* ds)
+    {
+      if(!operation || !ds)
+      {
+        return false;
+      }
+
+      SampleType* sample = static_cast< SampleType* >(ds);
+
+      scoped_lock< NS_NaviCommon::SharedMutex > lock(operation->lock);
+
+      applyMode();
+
+      uint32_t sequence = operation->head + 1;
+      DataSetSlot& slot = operation->slots[sequence
+          % slotCount(transport_mode)];
+
+      NS_NaviCommon::atomicStore(&slot.version, slot.version + 1);
+      NS_NaviCommon::releaseFence();
+
+      retireSlot(slot);
+
+      slot.sequence = sequence;
+      slot.length = 0;
+      slot.count = 1;
+      slot.handle = obj_segment.get_handle_from_address(sample);
+      slot.stamp = NS_NaviCommon::SharedEvent::now();
+
+      NS_NaviCommon::atomicStore(&slot.version, slot.version + 1);
+      NS_NaviCommon::atomicStore(&operation->head, sequence);
+
+      NS_NaviCommon::recordPublish(operation->statistics);
+
+      notifyReaders(operation);
+
+      return waitDelivered(operation, lock, timeout);
+    }
+  };
+
+}
+
+#endif /* _DATASET_SHARED_PUBLISHER_H_ */
@@ -0,0 +1,298 @@
+/*
+ * SharedSubscriber.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: root
+ */
+
+#ifndef _DATASET_SHARED_SUBSCRIBER_H_
+#define _DATASET_SHARED_SUBSCRIBER_H_
+
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/interprocess/managed_shared_memory.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+#include "DataSet.h"
+#include "DataType/SharedDataTypes.h"
+#include "../Thread/Atomic.h"
+
+namespace NS_DataSet
+{
+
+  using namespace boost::interprocess;
+
+  /**
+   * \brief Subscriber of samples published by SharedPublisher.
+   *
+   * The callback gets the sample by reference, straight in the <name>_OBJ
+   * segment. It holds a reference on the sample meanwhile, so the publisher
+   * may move on in ring mode without pulling the sample from under it.
+   */
+  template< typename DataType >
+  class SharedSubscriber
+  {
+    typedef SharedSample< DataType > SampleType;
+    typedef boost::function< void(const DataType&) > DataCallbackType;
+  public:
+    SharedSubscriber(std::string name, DataCallbackType cb)
+    {
+      dataset_name = name;
+      callback = cb;
+      operation = NULL;
+      mapped = false;
+      reader_id = -1;
+      active = false;
+      cursor = 0;
+      lost = 0;
+
+      try
+      {
+        operation = attachOperation(dataset_name, oper_region);
+      }
+      catch(interprocess_exception& exception)
+      {
+        operation = NULL;
+      }
+
+      if(!operation)
+      {
+        printf("create shared dataset fail!\n");
+        return;
+      }
+
+      {
+        scoped_lock< NS_NaviCommon::SharedMutex > lock(operation->lock);
+
+        if(operation->lock.recovered())
+        {
+          recoverOperation(operation);
+        }
+
+        reclaimReaders(operation);
+
+        NS_NaviCommon::TypeSignature signature =
+            NS_NaviCommon::typeSignature< DataType >(
+                NS_NaviCommon::WIRE_SHARED_OBJECT);
+        if(!bindDataSetType(operation, signature))
+        {
+          printf("dataset %s carries %s, can not subscribe as %s!\n",
+                 dataset_name.c_str(), operation->type.name, signature.name);
+          return;
+        }
+
+        for(int i = 0; i < DATASET_MAX_SUBSCRIBERS; i++)
+        {
+          if(!operation->readers[i].active
+              && !holdsSamples(operation->readers[i]))
+          {
+            reader_id = i;
+            break;
+          }
+        }
+
+        if(reader_id < 0)
+        {
+          printf("too many subscribers on dataset %s!\n",
+                 dataset_name.c_str());
+          return;
+        }
+
+        cursor = attachCursor(operation);
+        operation->readers[reader_id].cursor = cursor;
+        operation->readers[reader_id].blocking = 1;
+        operation->readers[reader_id].pid = NS_NaviCommon::currentProcess();
+        operation->readers[reader_id].heartbeat =
+            NS_NaviCommon::SharedEvent::now();
+        operation->readers[reader_id].active = 1;
+      }
+
+      pinned.reserve(DATASET_RING_SLOTS);
+      stamps.reserve(DATASET_RING_SLOTS);
+
+      active = true;
+      dataset_thread = boost::thread(
+          boost::bind(&SharedSubscriber::processor, this));
+    }
+
+    virtual ~SharedSubscriber()
+    {
+      if(active)
+      {
+        {
+          scoped_lock< NS_NaviCommon::SharedMutex > lock(operation->lock);
+          active = false;
+        }
+        operation->req_event.notify();
+        dataset_thread.join();
+      }
+
+      if(operation && reader_id >= 0)
+      {
+        scoped_lock< NS_NaviCommon::SharedMutex > lock(operation->lock);
+        operation->readers[reader_id].active = 0;
+        operation->rep_event.notify();
+      }
+    }
+
+    /**
+     * \brief Number of samples overwritten before this subscriber read them
+     */
+    uint32_t getLost()
+    {
+      return lost;
+    }
+
+  private:
+    std::string dataset_name;
+
+    DataCallbackType callback;
+
+    DataSetOperation* operation;
+
+    boost::thread dataset_thread;
+
+    mapped_region oper_region;
+
+    NS_DataType::SharedObjectSegment obj_segment;
+    bool mapped;
+
+    int reader_id;
+    uint32_t cursor;
+    uint32_t lost;
+
+    /*
+     * samples referenced for the callbacks of the current round, with the
+     * time they were published
+     */
+    std::vector< SampleType* > pinned;
+    std::vector< uint64_t > stamps;
+
+    bool active;
+
+  private:
+
+    /*
+     * the segment is created by the publisher, map it with the first sample
+     */
+    bool mapSegment()
+    {
+      if(!mapped)
+      {
+        try
+        {
+          obj_segment = NS_DataType::SharedObjectSegment(
+              open_only, (dataset_name + "_OBJ").c_str());
+          mapped = true;
+        }
+        catch(interprocess_exception& exception)
+        {
+          mapped = false;
+        }
+      }
+
+      return mapped;
+    }
+
+    /*
+     * reference every sample published up to head, the lock is held so the
+     * publisher can not retire them meanwhile. They are recorded in the
+     * reader entry until released
+     */
+    void pinPending()
+    {
+      uint32_t head = operation->head;
+      uint32_t count = slotCount(operation->mode);
+
+      uint32_t pending = head - cursor;
+      if(pending > count)
+      {
+        lost += pending - count;
+        cursor = head - count;
+      }
+
+      bool available = mapSegment();
+
+      while(cursor != head)
+      {
+        cursor++;
+
+        DataSetSlot& slot = operation->slots[cursor % count];
+        if(!available || slot.sequence != cursor || !slot.handle)
+        {
+          lost++;
+          continue;
+        }
+
+        SampleType* sample = static_cast< SampleType* >(
+            obj_segment.get_address_from_handle(slot.handle));
+        sample->retain();
+        operation->readers[reader_id].pinned[pinned.size()] = slot.handle;
+        pinned.push_back(sample);
+        stamps.push_back(slot.stamp);
+      }
+    }
+
+    void processor()
+    {
+      while(active)
+      {
+        scoped_lock< NS_NaviCommon::SharedMutex > lock(operation->lock);
+
+        while(active && operation->head == cursor)
+        {
+          operation->readers[reader_id].heartbeat =
+              NS_NaviCommon::SharedEvent::now();
+          operation->req_event.wait(
+              lock,
+              NS_NaviCommon::SharedEvent::deadline(
+                  NS_NaviCommon::HEARTBEAT_PERIOD));
+        }
+
+        if(!active)
+        {
+          break;
+        }
+
+        if(operation->lock.recovered())
+        {
+          recoverOperation(operation);
+        }
+        operation->readers[reader_id].heartbeat =
+            NS_NaviCommon::SharedEvent::now();
+
+        pinPending();
+
+        lock.unlock();
+
+        for(size_t i = 0; i < pinned.size(); i++)
+        {
+          if(active && callback)
+          {
+            callback(*pinned[i]);
+            NS_NaviCommon::recordDelivery(operation->statistics, stamps[i]);
+          }
+        }
+
+        lock.lock();
+
+        /*
+         * the record goes first: dying in between leaks the sample, it is
+         * never released twice
+         */
+        for(size_t i = 0; i < pinned.size(); i++)
+        {
+          operation->readers[reader_id].pinned[i] = 0;
+          SampleType::release(obj_segment, pinned[i]);
+        }
+        pinned.clear();
+        stamps.clear();
+
+        operation->readers[reader_id].cursor = cursor;
+        operation->rep_event.notify();
+      }
+    }
+  };
+
+}
+
+#endif /* _DATASET_SHARED_SUBSCRIBER_H_ */
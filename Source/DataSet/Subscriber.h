@@ -8,132 +8,288 @@
 #ifndef _DATASET_SUBSCRIBER_H_
 #define _DATASET_SUBSCRIBER_H_
 
-#include <boost/interprocess/shared_memory_object.hpp>
-#include <boost/interprocess/mapped_region.hpp>
-#include <boost/interprocess/sync/scoped_lock.hpp>
-#include "DataSet.h"
+#include <vector>
+#include <exception>
+#include <boost/bind.hpp>
+#include "SubscriberBase.h"
 #include "../Serialization/Serialization.h"
 
 namespace NS_DataSet
 {
 
-  using namespace boost::interprocess;
-
+  /**
+   * \brief Subscriber which deserializes every sample for its callback.
+   *
+   * history is DATASET_KEEP_ALL, DATASET_LATEST_ONLY or the number of newest
+   * samples to keep: a subscriber which does not keep all of them never holds
+   * the publisher back and skips the samples it is too slow for, see
+   * getConflated().
+   *
+   * Samples published in the same process are not serialized: the callback
+   * gets a copy of the publisher's sample, see ConstSubscriber to share it
+   * instead. The publishing thread adds them to the queue, if one is given,
+   * and the callback is run by whoever spins it; without a queue they are
+   * called in a delivery thread of the subscriber, or, if synchronous is
+   * set, right away in the publishing thread, which then waits for the
+   * callback. History does not apply to them: a subscriber with neither a
+   * queue nor DATASET_KEEP_ALL gets them through the shared segment, so it
+   * never holds the publisher back.
+   *
+   * With a queue the samples of other processes are delivered through it as
+   * well and the subscriber has no thread of its own, see SubscriberBase.
+   */
   template< typename DataType >
-  class Subscriber
+  class Subscriber: public SubscriberBase
   {
     typedef boost::function< void(DataType&) > DataCallbackType;
+    typedef IntraProcessReceiver< DataType > Receiver;
   public:
-    Subscriber(std::string name, DataCallbackType cb)
+    Subscriber(std::string name, DataCallbackType cb,
+               uint32_t history = DATASET_KEEP_ALL,
+               NS_NaviCommon::CallbackQueueInterface* queue = NULL,
+               bool synchronous = false)
+        : SubscriberBase(name, false, history, queue)
     {
-      dataset_name = name;
       callback = cb;
-      makeSrv();
+      NS_NaviCommon::TypeSignature signature =
+          NS_NaviCommon::typeSignature< DataType >();
+      start(&signature,
+            IntraProcessLinkPtr(
+                new Receiver(boost::bind(&Subscriber::receive, this, _1),
+                             queue, synchronous)));
     }
 
     virtual ~Subscriber()
     {
-      if(active)
-      {
-        active = false;
-        dataset_thread.join();
-      }
+      shutdown();
     }
   private:
-    std::string dataset_name;
     DataCallbackType callback;
-    DataSetOperation* operation;
-
-    boost::mutex proc_lock;
-
-    boost::thread dataset_thread;
 
-    mapped_region oper_region;
-    mapped_region ds_region;
+    void receive(const typename Receiver::Batch& batch)
+    {
+      if(callback)
+      {
+        for(size_t i = 0; i < batch.size(); i++)
+        {
+          DataType ds(*batch[i]);
 
-    bool active;
-  private:
+          callback(ds);
+        }
+      }
+    }
 
-    void makeSrv()
+  protected:
+    virtual void deliver(const DataSetView& view)
     {
-      //shared_memory_object::remove (dataset_name.c_str ());
-
-      try
+      if(callback)
       {
-        shared_memory_object oper_shm(open_or_create, dataset_name.c_str(),
-                                      read_write);
+        NS_NaviCommon::IStream stream = view.getStream();
+
+        for(uint32_t i = 0; i < view.getCount(); i++)
+        {
+          DataType ds;
 
-        oper_shm.truncate(sizeof(DataSetOperation));
+          NS_NaviCommon::deserialize(stream, ds);
 
-        oper_region = mapped_region(oper_shm, read_write);
+          callback(ds);
+        }
+      }
+    }
+  };
 
-        void* region_addr = oper_region.get_address();
+  /**
+   * \brief Subscriber whose callback takes every sample as a shared pointer
+   * to a constant message.
+   *
+   * Samples published in the same process reach it without serialization
+   * or copy, the pointer is shared with the publisher and the other
+   * subscribers of the process. The others are deserialized once into a
+   * new message. Otherwise it behaves like Subscriber.
+   */
+  template< typename DataType >
+  class ConstSubscriber: public SubscriberBase
+  {
+    typedef boost::shared_ptr< const DataType > DataConstPtr;
+    typedef boost::function< void(const DataConstPtr&) > DataCallbackType;
+    typedef IntraProcessReceiver< DataType > Receiver;
+  public:
+    ConstSubscriber(std::string name, DataCallbackType cb,
+                    uint32_t history = DATASET_KEEP_ALL,
+                    NS_NaviCommon::CallbackQueueInterface* queue = NULL,
+                    bool synchronous = false)
+        : SubscriberBase(name, false, history, queue)
+    {
+      callback = cb;
+      NS_NaviCommon::TypeSignature signature =
+          NS_NaviCommon::typeSignature< DataType >();
+      start(&signature,
+            IntraProcessLinkPtr(
+                new Receiver(boost::bind(&ConstSubscriber::receive, this, _1),
+                             queue, synchronous)));
+    }
 
-        operation = new (region_addr) DataSetOperation;
+    virtual ~ConstSubscriber()
+    {
+      shutdown();
+    }
+  private:
+    DataCallbackType callback;
 
-      }
-      catch(interprocess_exception&_exception)
+    void receive(const typename Receiver::Batch& batch)
+    {
+      if(callback)
       {
-        printf("create dataset fail!\n");
-        return;
+        for(size_t i = 0; i < batch.size(); i++)
+        {
+          callback(batch[i]);
+        }
       }
-
-      active = true;
-      dataset_thread = boost::thread(boost::bind(&Subscriber::processor, this));
-
-      return;
     }
 
-    void*
-    getSrv()
+  protected:
+    virtual void deliver(const DataSetView& view)
     {
-      std::string ds_shm_name = dataset_name + "_DS";
+      if(callback)
+      {
+        NS_NaviCommon::IStream stream = view.getStream();
 
-      shared_memory_object ds_shm(open_only, ds_shm_name.c_str(), read_write);
+        for(uint32_t i = 0; i < view.getCount(); i++)
+        {
+          boost::shared_ptr< DataType > ds(new DataType);
 
-      ds_region = mapped_region(ds_shm, read_write);
+          NS_NaviCommon::deserialize(stream, *ds);
 
-      void* region_addr = ds_region.get_address();
+          callback(ds);
+        }
+      }
+    }
+  };
+
+  /**
+   * \brief Subscriber which hands every sample to its callback at once, the
+   * messages of a Publisher::publishBatch() together and any other sample as
+   * a batch of one. Samples of the same process are copied into the batch,
+   * see Subscriber.
+   */
+  template< typename DataType >
+  class BatchSubscriber: public SubscriberBase
+  {
+    typedef boost::function< void(std::vector< DataType >&) > BatchCallbackType;
+    typedef IntraProcessReceiver< DataType > Receiver;
+  public:
+    BatchSubscriber(std::string name, BatchCallbackType cb,
+                    uint32_t history = DATASET_KEEP_ALL,
+                    NS_NaviCommon::CallbackQueueInterface* queue = NULL,
+                    bool synchronous = false)
+        : SubscriberBase(name, false, history, queue)
+    {
+      callback = cb;
+      NS_NaviCommon::TypeSignature signature =
+          NS_NaviCommon::typeSignature< DataType >();
+      start(&signature,
+            IntraProcessLinkPtr(
+                new Receiver(boost::bind(&BatchSubscriber::receive, this, _1),
+                             queue, synchronous)));
+    }
 
-      return region_addr;
+    virtual ~BatchSubscriber()
+    {
+      shutdown();
     }
+  private:
+    BatchCallbackType callback;
+    std::vector< DataType > batch;
 
-    void processor()
+    void receive(const typename Receiver::Batch& samples)
     {
-      while(active)
+      if(callback)
       {
-        if(operation)
+        batch.resize(samples.size());
+        for(size_t i = 0; i < samples.size(); i++)
         {
-          bool timeout = false;
-
-          scoped_lock< interprocess_mutex > lock(operation->lock);
+          batch[i] = *samples[i];
+        }
 
-          while(operation->status == DATASET_IDLE)
-          {
-            timeout = operation->req_cond.timed_wait(
-                lock,
-                (boost::get_system_time() + boost::posix_time::seconds(1)));
-          }
+        callback(batch);
+      }
+    }
 
-          if(callback && !timeout)
-          {
-            unsigned char* addr = (unsigned char*)getSrv();
+  protected:
+    virtual void deliver(const DataSetView& view)
+    {
+      if(callback)
+      {
+        NS_NaviCommon::IStream stream = view.getStream();
 
-            DataType ds;
+        batch.resize(view.getCount());
+        for(uint32_t i = 0; i < view.getCount(); i++)
+        {
+          NS_NaviCommon::deserialize(stream, batch[i]);
+        }
 
-            NS_NaviCommon::IStream stream(addr, operation->buf_len);
+        callback(batch);
+      }
+    }
+  };
 
-            NS_NaviCommon::deserialize(stream, ds);
+  /**
+   * \brief Subscriber which hands out the serialized sample in place.
+   *
+   * The callback reads straight from the shared segment, through the lazy
+   * view of its type (e.g. NS_DataType::OccupancyGridView over getStream()),
+   * or NS_NaviCommon::deserialize for small fields and
+   * NS_NaviCommon::readArrayView for large arrays, so nothing is copied or
+   * allocated until it asks for it. The view is only
+   * valid during the callback; in ring mode, or with a history other than
+   * DATASET_KEEP_ALL, check DataSetView::intact() after reading. A sample
+   * overwritten while the callback reads it may make the reads throw, such
+   * a sample is dropped and the exception does not leave the subscriber.
+   */
+  class ViewSubscriber: public SubscriberBase
+  {
+    typedef boost::function< void(const DataSetView&) > ViewCallbackType;
+  public:
+    ViewSubscriber(std::string name, ViewCallbackType cb,
+                   uint32_t history = DATASET_KEEP_ALL,
+                   NS_NaviCommon::CallbackQueueInterface* queue = NULL)
+        : SubscriberBase(name, true, history, queue)
+    {
+      callback = cb;
+      start();
+    }
 
-            callback(ds);
+    virtual ~ViewSubscriber()
+    {
+      shutdown();
+    }
+  private:
+    ViewCallbackType callback;
 
-            operation->status = DATASET_IDLE;
-            operation->rep_cond.notify_all();
+  protected:
+    virtual void deliver(const DataSetView& view)
+    {
+      if(callback)
+      {
+        try
+        {
+          callback(view);
+        }
+        catch(std::exception&)
+        {
+          /*
+           * a sample the publisher rewrote under the callback may hold any
+           * length, reading it can overrun the stream or ask for a huge
+           * allocation: drop it, readSlot() sees it is no longer intact.
+           * An intact sample which fails to read is a real error
+           */
+          if(view.intact())
+          {
+            throw;
           }
         }
       }
     }
-
   };
 
 }
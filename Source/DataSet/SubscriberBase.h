@@ -0,0 +1,594 @@
+/*
+ * SubscriberBase.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: root
+ */
+
+#ifndef _DATASET_SUBSCRIBER_BASE_H_
+#define _DATASET_SUBSCRIBER_BASE_H_
+
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+#include "DataSet.h"
+#include "IntraProcess.h"
+#include "../Callbacks/ReceiveMultiplexer.h"
+#include "../Common/SharedSegment.h"
+#include "../Thread/Atomic.h"
+
+namespace NS_DataSet
+{
+
+  using namespace boost::interprocess;
+
+  /**
+   * \brief Type independent part of a dataset subscriber: attaching to the
+   * control block, the reader entry, the receive thread and slot access.
+   *
+   * Derived classes call start() at the end of their constructor and
+   * shutdown() at the beginning of their destructor, every sample is handed
+   * to deliver() as a view over the serialized bytes.
+   *
+   * Given a callback queue the subscriber has no thread: the
+   * ReceiveMultiplexer of the process watches the dataset and the samples
+   * are delivered by whichever thread spins the queue. In handshake mode the
+   * publisher waits for that, so the queue must be spun.
+   */
+  class SubscriberBase: public NS_NaviCommon::MultiplexedChannel
+  {
+  public:
+    /**
+     * \param zero_copy when the publisher does not wait for this subscriber,
+     * deliver views straight into the shared segment instead of a private
+     * copy of the slot
+     * \param history DATASET_KEEP_ALL, DATASET_LATEST_ONLY or the number of
+     * newest samples to keep
+     * \param queue callback queue to deliver the samples through, NULL for a
+     * receive thread of its own
+     */
+    SubscriberBase(std::string name, bool zero_copy, uint32_t history,
+                   NS_NaviCommon::CallbackQueueInterface* queue = NULL)
+    {
+      dataset_name = name;
+      in_place = zero_copy;
+      depth = history;
+      callback_queue = queue;
+      doorbell = 0;
+      queued = false;
+      operation = NULL;
+      reader_id = -1;
+      process = NS_NaviCommon::currentProcess();
+      attach_head = 0;
+      active = false;
+      cursor = 0;
+      lost = 0;
+      conflated = 0;
+    }
+
+    virtual ~SubscriberBase()
+    {
+      shutdown();
+    }
+
+    /**
+     * \brief Number of ring slots overwritten before this subscriber read them
+     */
+    uint32_t getLost()
+    {
+      return lost;
+    }
+
+    /**
+     * \brief Number of samples skipped because newer ones were pending,
+     * always 0 with DATASET_KEEP_ALL
+     */
+    uint32_t getConflated()
+    {
+      return conflated;
+    }
+
+  protected:
+    virtual void
+    deliver(const DataSetView& view) = 0;
+
+    /*
+     * signature is the message type the subscriber deserializes, NULL for
+     * one which takes any. A typed subscriber passes its intra-process link
+     * as well, publishers of this process hand their samples to it instead
+     * of going through the shared segment. Without a queue the link queues
+     * every sample for its own thread, or runs the callbacks in the
+     * publishing thread, so it is only used by a subscriber keeping every
+     * sample
+     */
+    void start(const NS_NaviCommon::TypeSignature* signature = NULL,
+               const IntraProcessLinkPtr& intra = IntraProcessLinkPtr())
+    {
+      try
+      {
+        operation = attachOperation(dataset_name, oper_region);
+      }
+      catch(interprocess_exception& exception)
+      {
+        operation = NULL;
+      }
+
+      if(!operation)
+      {
+        printf("create dataset fail!\n");
+        return;
+      }
+
+      if(callback_queue)
+      {
+        doorbell = NS_NaviCommon::ReceiveMultiplexer::instance().getDoorbell();
+      }
+
+      {
+        scoped_lock< NS_NaviCommon::SharedMutex > lock(operation->lock);
+
+        if(operation->lock.recovered())
+        {
+          recoverOperation(operation);
+        }
+
+        /*
+         * entries left by subscribers that died are taken again
+         */
+        reclaimReaders(operation);
+
+        if(signature && !bindDataSetType(operation, *signature))
+        {
+          printf("dataset %s carries %s, can not subscribe as %s!\n",
+                 dataset_name.c_str(), operation->type.name, signature->name);
+          return;
+        }
+
+        for(int i = 0; i < DATASET_MAX_SUBSCRIBERS; i++)
+        {
+          if(!operation->readers[i].active)
+          {
+            reader_id = i;
+            break;
+          }
+        }
+
+        if(reader_id < 0)
+        {
+          printf("too many subscribers on dataset %s!\n",
+                 dataset_name.c_str());
+          return;
+        }
+
+        IntraProcessLinkPtr local;
+        if(intra && (intra->queued() || depth == DATASET_KEEP_ALL))
+        {
+          local = intra;
+        }
+
+        cursor = attachCursor(operation);
+        attach_head = operation->head;
+        operation->readers[reader_id].cursor = cursor;
+        operation->readers[reader_id].blocking = (depth == DATASET_KEEP_ALL);
+        operation->readers[reader_id].pid = process;
+        operation->readers[reader_id].local = local ? 1 : 0;
+        operation->readers[reader_id].doorbell = doorbell;
+        operation->readers[reader_id].heartbeat =
+            NS_NaviCommon::SharedEvent::now();
+        operation->readers[reader_id].active = 1;
+
+        if(local)
+        {
+          link = local;
+          link->open();
+          IntraProcessRegistry::instance().add(dataset_name, link);
+        }
+      }
+
+      ds_segment.setName(dataset_name + "_DS");
+
+      active = true;
+      if(doorbell)
+      {
+        NS_NaviCommon::ReceiveMultiplexer::instance().add(this);
+      }
+      else
+      {
+        dataset_thread = boost::thread(
+            boost::bind(&SubscriberBase::processor, this));
+      }
+    }
+
+    void shutdown()
+    {
+      if(active)
+      {
+        {
+          scoped_lock< NS_NaviCommon::SharedMutex > lock(operation->lock);
+          active = false;
+        }
+
+        if(doorbell)
+        {
+          NS_NaviCommon::ReceiveMultiplexer::instance().remove(this);
+          callback_queue->removeByID((unsigned long)this);
+        }
+        else
+        {
+          operation->req_event.notify();
+          dataset_thread.join();
+        }
+      }
+
+      if(operation && reader_id >= 0)
+      {
+        scoped_lock< NS_NaviCommon::SharedMutex > lock(operation->lock);
+        operation->readers[reader_id].active = 0;
+        operation->rep_event.notify();
+        reader_id = -1;
+
+        if(link)
+        {
+          IntraProcessRegistry::instance().remove(dataset_name, link);
+        }
+      }
+
+      if(link)
+      {
+        link->detach();
+        link.reset();
+      }
+    }
+
+  private:
+    std::string dataset_name;
+    bool in_place;
+    uint32_t depth;
+
+    DataSetOperation* operation;
+
+    /*
+     * with a doorbell the multiplexer polls the dataset and at most one
+     * receive callback is queued at a time, see poll()
+     */
+    NS_NaviCommon::CallbackQueueInterface* callback_queue;
+    uint32_t doorbell;
+    bool queued;
+
+    boost::mutex proc_lock;
+
+    boost::thread dataset_thread;
+
+    mapped_region oper_region;
+
+    NS_NaviCommon::SharedSegment ds_segment;
+
+    /*
+     * entry in the reader table of the control block, cursor is the
+     * sequence of the last sample consumed by this subscriber and
+     * slot_buffer holds the private copy of the ring slot being delivered
+     */
+    int reader_id;
+    uint32_t process;
+    uint32_t cursor;
+    uint32_t lost;
+    uint32_t conflated;
+    std::vector< uint8_t > slot_buffer;
+
+    /*
+     * samples published in this process after the subscriber attached came
+     * in-process through link, it skips their slots
+     */
+    IntraProcessLinkPtr link;
+    uint32_t attach_head;
+
+    bool active;
+
+  private:
+
+    bool served(const DataSetSlot& slot, uint32_t sequence)
+    {
+      return link && slot.served == process
+          && (int32_t)(sequence - attach_head) > 0;
+    }
+
+    /*
+     * callbacks of samples from other processes and the in-process ones
+     * never overlap
+     */
+    void dispatch(const DataSetView& view)
+    {
+      if(link)
+      {
+        boost::mutex::scoped_lock lock(link->callbackLock());
+        deliver(view);
+      }
+      else
+      {
+        deliver(view);
+      }
+    }
+
+    /*
+     * deliver sample `sequence` out of count slots, false if the publisher
+     * has overwritten it or is rewriting it right now
+     */
+    bool readSlot(uint32_t sequence, uint32_t count)
+    {
+      if(!ds_segment.sync(operation->capacity, operation->generation))
+      {
+        return false;
+      }
+
+      uint32_t generation = ds_segment.getGeneration();
+
+      size_t slot_capacity = ds_segment.getCapacity() / count;
+      uint32_t index = sequence % count;
+      DataSetSlot& slot = operation->slots[index];
+      uint8_t* data = ds_segment.getAddress() + index * slot_capacity;
+
+      uint32_t version = NS_NaviCommon::atomicLoad(&slot.version);
+      if(version & 1)
+      {
+        return false;
+      }
+
+      size_t length = slot.length;
+      uint32_t messages = slot.count;
+      uint64_t stamp = slot.stamp;
+      if(slot.sequence != sequence || length > slot_capacity)
+      {
+        return false;
+      }
+
+      if(served(slot, sequence))
+      {
+        return true;
+      }
+
+      if(in_place)
+      {
+        DataSetView view(data, length, messages, &slot.version, version,
+                         &operation->generation, generation);
+        if(!view.intact())
+        {
+          return false;
+        }
+
+        dispatch(view);
+        if(!view.intact())
+        {
+          return false;
+        }
+
+        NS_NaviCommon::recordDelivery(operation->statistics, stamp, messages);
+        return true;
+      }
+
+      slot_buffer.resize(length);
+      if(length > 0)
+      {
+        memcpy(&slot_buffer.front(), data, length);
+      }
+
+      NS_NaviCommon::acquireFence();
+
+      if(NS_NaviCommon::atomicLoad(&slot.version) != version
+          || NS_NaviCommon::atomicLoad(&operation->generation) != generation)
+      {
+        return false;
+      }
+
+      dispatch(
+          DataSetView(slot_buffer.empty() ? NULL : &slot_buffer.front(),
+                      length, messages));
+
+      NS_NaviCommon::recordDelivery(operation->statistics, stamp, messages);
+      return true;
+    }
+
+    /*
+     * deliver the slots published up to head, the newest depth of them if
+     * the history is limited. The lock is not held so the publisher never
+     * waits for the callbacks
+     */
+    void drain(uint32_t head, uint32_t count)
+    {
+      uint32_t keep = count;
+      if(depth != DATASET_KEEP_ALL && depth < count)
+      {
+        keep = depth;
+      }
+
+      uint32_t pending = head - cursor;
+      if(pending > keep)
+      {
+        if(depth == DATASET_KEEP_ALL)
+        {
+          lost += pending - keep;
+        }
+        else
+        {
+          conflated += pending - keep;
+        }
+        cursor = head - keep;
+      }
+
+      while(active && cursor != head)
+      {
+        cursor++;
+
+        if(!readSlot(cursor, count))
+        {
+          lost++;
+        }
+      }
+
+      NS_NaviCommon::atomicStore(&operation->readers[reader_id].cursor,
+                                 cursor);
+    }
+
+    /*
+     * handshake mode with a blocking subscriber, the publisher waits for it
+     * and the lock is held, so the slot is read in place
+     */
+    void receive()
+    {
+      uint32_t head = operation->head;
+      DataSetSlot& slot = operation->slots[0];
+
+      if(slot.sequence == head && !served(slot, head)
+          && ds_segment.sync(operation->capacity, operation->generation))
+      {
+        dispatch(DataSetView(ds_segment.getAddress(), slot.length, slot.count));
+        NS_NaviCommon::recordDelivery(operation->statistics, slot.stamp,
+                                      slot.count);
+      }
+
+      cursor = head;
+      operation->readers[reader_id].cursor = head;
+      operation->rep_event.notify();
+    }
+
+    void processor()
+    {
+      while(active)
+      {
+        scoped_lock< NS_NaviCommon::SharedMutex > lock(operation->lock);
+
+        /*
+         * wake up at least every heartbeat period to show the subscriber
+         * is still there
+         */
+        while(active && operation->head == cursor)
+        {
+          operation->readers[reader_id].heartbeat =
+              NS_NaviCommon::SharedEvent::now();
+          operation->req_event.wait(
+              lock,
+              NS_NaviCommon::SharedEvent::deadline(
+                  NS_NaviCommon::HEARTBEAT_PERIOD));
+        }
+
+        if(!active)
+        {
+          break;
+        }
+
+        if(operation->lock.recovered())
+        {
+          recoverOperation(operation);
+        }
+        operation->readers[reader_id].heartbeat =
+            NS_NaviCommon::SharedEvent::now();
+
+        consume(lock);
+      }
+    }
+
+    /*
+     * deliver what was published since cursor, called with the lock held;
+     * it is released while draining a ring or a limited history
+     */
+    void consume(scoped_lock< NS_NaviCommon::SharedMutex >& lock)
+    {
+      if(operation->mode == DATASET_MODE_RING || depth != DATASET_KEEP_ALL)
+      {
+        uint32_t head = operation->head;
+        uint32_t count = slotCount(operation->mode);
+
+        lock.unlock();
+
+        drain(head, count);
+      }
+      else
+      {
+        receive();
+      }
+    }
+
+    class ReceiveCallback: public NS_NaviCommon::CallbackInterface
+    {
+    public:
+      ReceiveCallback(SubscriberBase* subscriber)
+          : subscriber_(subscriber)
+      {
+      }
+
+      CallResult call()
+      {
+        subscriber_->step();
+        return Success;
+      }
+
+    private:
+      SubscriberBase* subscriber_;
+    };
+
+    void queueReceive()
+    {
+      queued = true;
+      callback_queue->addCallback(
+          NS_NaviCommon::CallbackInterfacePtr(new ReceiveCallback(this)),
+          (unsigned long)this);
+    }
+
+  public:
+    /*
+     * called by the multiplexer, queues a receive when samples are pending
+     */
+    virtual void poll()
+    {
+      scoped_lock< NS_NaviCommon::SharedMutex > lock(operation->lock);
+
+      if(operation->lock.recovered())
+      {
+        recoverOperation(operation);
+      }
+      operation->readers[reader_id].heartbeat =
+          NS_NaviCommon::SharedEvent::now();
+
+      if(active && !queued && operation->head != cursor)
+      {
+        queueReceive();
+      }
+    }
+
+  private:
+    /*
+     * a queued receive, run by a spinner thread. Samples published
+     * meanwhile are taken by the next one, queued right away
+     */
+    void step()
+    {
+      scoped_lock< NS_NaviCommon::SharedMutex > lock(operation->lock);
+
+      if(active)
+      {
+        operation->readers[reader_id].heartbeat =
+            NS_NaviCommon::SharedEvent::now();
+
+        consume(lock);
+
+        if(!lock.owns())
+        {
+          lock.lock();
+        }
+      }
+
+      if(active && operation->head != cursor)
+      {
+        queueReceive();
+      }
+      else
+      {
+        queued = false;
+      }
+    }
+  };
+
+}
+
+#endif /* _DATASET_SUBSCRIBER_BASE_H_ */
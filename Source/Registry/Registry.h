@@ -0,0 +1,183 @@
+/*
+ * Registry.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: root
+ */
+
+#ifndef _REGISTRY_H_
+#define _REGISTRY_H_
+
+#include <dirent.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include "../DataSet/DataSet.h"
+#include "../Service/Service.h"
+
+namespace NS_NaviCommon
+{
+
+  typedef enum
+  {
+    ENDPOINT_DATASET,
+    ENDPOINT_SERVICE,
+  } EndpointKind;
+
+  /*
+   * one dataset or service found in shared memory. type is empty while no
+   * typed peer attached. owner is the publisher or server process,
+   * peers the number of subscribers of a dataset or busy slots of a
+   * service; alive is false once nobody running uses it. rate is in
+   * publishes or calls per second
+   */
+  typedef struct
+  {
+    EndpointKind kind;
+    std::string name;
+    std::string type;
+    bool fixed_size;
+    uint32_t owner;
+    uint32_t peers;
+    bool alive;
+    double rate;
+    uint64_t published;
+  } EndpointInfo;
+
+  /*
+   * read the control block of name, false if it is neither a dataset nor a
+   * service. The block is mapped read only and not locked, so the
+   * information is a snapshot and may be slightly inconsistent
+   */
+  inline bool inspectEndpoint(const std::string& name, EndpointInfo& info)
+  {
+    using namespace boost::interprocess;
+
+    shared_memory_object shm;
+    offset_t size = 0;
+
+    try
+    {
+      shm = shared_memory_object(open_only, name.c_str(), read_only);
+      if(!shm.get_size(size))
+      {
+        return false;
+      }
+
+      if(size == sizeof(NS_DataSet::DataSetOperation))
+      {
+        mapped_region region(shm, read_only);
+        NS_DataSet::DataSetOperation* operation =
+            static_cast< NS_DataSet::DataSetOperation* >(
+                region.get_address());
+
+        if(atomicLoad(&operation->magic) != NS_DataSet::DATASET_MAGIC)
+        {
+          return false;
+        }
+
+        info.kind = ENDPOINT_DATASET;
+        info.owner = operation->publisher_pid;
+        info.peers = 0;
+        for(int i = 0; i < NS_DataSet::DATASET_MAX_SUBSCRIBERS; i++)
+        {
+          if(operation->readers[i].active)
+          {
+            info.peers++;
+          }
+        }
+        info.alive = !NS_DataSet::abandoned(operation);
+        info.type.assign(operation->type.name,
+                         strnlen(operation->type.name, TYPE_NAME_LENGTH));
+        info.fixed_size = operation->type.fixed_size != 0;
+        info.rate = publishRate(operation->statistics);
+        info.published = operation->statistics.published;
+      }
+      else if(size == sizeof(NS_Service::ServiceOperation))
+      {
+        mapped_region region(shm, read_only);
+        NS_Service::ServiceOperation* operation =
+            static_cast< NS_Service::ServiceOperation* >(
+                region.get_address());
+
+        if(atomicLoad(&operation->magic) != NS_Service::SERVICE_MAGIC)
+        {
+          return false;
+        }
+
+        info.kind = ENDPOINT_SERVICE;
+        info.owner = operation->server_pid;
+        info.peers = 0;
+        for(uint32_t i = 0; i < NS_Service::SERVICE_SLOTS; i++)
+        {
+          if(operation->slots[i].status != NS_Service::SERVICE_SLOT_FREE)
+          {
+            info.peers++;
+          }
+        }
+        info.alive = NS_Service::serverAlive(operation);
+        info.type.assign(operation->type.name,
+                         strnlen(operation->type.name, TYPE_NAME_LENGTH));
+        info.fixed_size = operation->type.fixed_size != 0;
+        info.rate = publishRate(operation->statistics);
+        info.published = operation->statistics.published;
+      }
+      else
+      {
+        return false;
+      }
+    }
+    catch(boost::interprocess::interprocess_exception& exception)
+    {
+      return false;
+    }
+
+    info.name = name;
+
+    return true;
+  }
+
+  /**
+   * \brief List the datasets and services under /dev/shm, sorted by name,
+   * with their message types and rates; the ones nobody alive uses any
+   * more only if all is set.
+   */
+  inline void listEndpoints(std::vector< EndpointInfo >& endpoints,
+                            bool all = false)
+  {
+    endpoints.clear();
+
+    DIR* dir = opendir("/dev/shm");
+    if(!dir)
+    {
+      return;
+    }
+
+    std::vector< std::string > names;
+    struct dirent* entry;
+    while((entry = readdir(dir)) != NULL)
+    {
+      if(entry->d_name[0] != '.')
+      {
+        names.push_back(entry->d_name);
+      }
+    }
+    closedir(dir);
+
+    std::sort(names.begin(), names.end());
+
+    for(size_t i = 0; i < names.size(); i++)
+    {
+      EndpointInfo info;
+      if(inspectEndpoint(names[i], info) && (all || info.alive))
+      {
+        endpoints.push_back(info);
+      }
+    }
+  }
+
+}
+
+#endif /* _REGISTRY_H_ */
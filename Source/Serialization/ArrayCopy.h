@@ -0,0 +1,186 @@
+/*
+ * ArrayCopy.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: root
+ */
+
+#ifndef _ARRAY_COPY_H_
+#define _ARRAY_COPY_H_
+
+#include <stdint.h>
+#include <string.h>
+#include <boost/integer.hpp>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define NAVI_ARRAY_COPY_NEON
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define NAVI_ARRAY_COPY_SSE2
+#endif
+
+namespace NS_NaviCommon
+{
+
+  /*
+   * reverse the bytes of one scalar of Size bytes
+   */
+  template< size_t Size >
+  struct ByteSwap
+  {
+  };
+
+  template< >
+  struct ByteSwap< 1 >
+  {
+    static inline uint8_t swap(uint8_t v)
+    {
+      return v;
+    }
+  };
+
+  template< >
+  struct ByteSwap< 2 >
+  {
+    static inline uint16_t swap(uint16_t v)
+    {
+      return (uint16_t)((v << 8) | (v >> 8));
+    }
+  };
+
+  template< >
+  struct ByteSwap< 4 >
+  {
+    static inline uint32_t swap(uint32_t v)
+    {
+      return __builtin_bswap32(v);
+    }
+  };
+
+  template< >
+  struct ByteSwap< 8 >
+  {
+    static inline uint64_t swap(uint64_t v)
+    {
+      return __builtin_bswap64(v);
+    }
+  };
+
+  /**
+   * \brief Returns v with its bytes in the opposite order, for scalars read from data of the
+   * other byte order
+   */
+  template< typename T >
+  inline T byteSwap(T v)
+  {
+    typedef typename boost::uint_t< sizeof(T) * 8 >::exact Bits;
+
+    Bits bits;
+    memcpy(&bits, &v, sizeof(T));
+    bits = ByteSwap< sizeof(T) >::swap(bits);
+    memcpy(&v, &bits, sizeof(T));
+    return v;
+  }
+
+  /*
+   * swap count elements of Size bytes from src to dst, 16 bytes at a time where NEON or SSE2 is
+   * available. Neither pointer needs to be aligned and they may be the same
+   */
+  template< size_t Size >
+  inline void swapArray(uint8_t* dst, const uint8_t* src, uint32_t count)
+  {
+    uint32_t i = 0;
+    const uint32_t per_block = 16 / Size;
+
+#if defined(NAVI_ARRAY_COPY_NEON)
+    for(; i + per_block <= count; i += per_block)
+    {
+      uint8x16_t block = vld1q_u8(src + i * Size);
+      if(Size == 2)
+      {
+        block = vrev16q_u8(block);
+      }
+      else if(Size == 4)
+      {
+        block = vrev32q_u8(block);
+      }
+      else
+      {
+        block = vrev64q_u8(block);
+      }
+      vst1q_u8(dst + i * Size, block);
+    }
+#elif defined(NAVI_ARRAY_COPY_SSE2)
+    /*
+     * SSE2 has no byte shuffle: swap the bytes of every 16 bit word, then
+     * reverse the words within each element
+     */
+    for(; i + per_block <= count; i += per_block)
+    {
+      __m128i block = _mm_loadu_si128((const __m128i*)(src + i * Size));
+      block = _mm_or_si128(_mm_slli_epi16(block, 8), _mm_srli_epi16(block, 8));
+      if(Size == 4)
+      {
+        block = _mm_shufflelo_epi16(block, _MM_SHUFFLE(2, 3, 0, 1));
+        block = _mm_shufflehi_epi16(block, _MM_SHUFFLE(2, 3, 0, 1));
+      }
+      else if(Size == 8)
+      {
+        block = _mm_shufflelo_epi16(block, _MM_SHUFFLE(0, 1, 2, 3));
+        block = _mm_shufflehi_epi16(block, _MM_SHUFFLE(0, 1, 2, 3));
+      }
+      _mm_storeu_si128((__m128i*)(dst + i * Size), block);
+    }
+#endif
+
+    typedef typename boost::uint_t< Size * 8 >::exact Bits;
+    for(; i < count; i++)
+    {
+      Bits bits;
+      memcpy(&bits, src + i * Size, Size);
+      bits = ByteSwap< Size >::swap(bits);
+      memcpy(dst + i * Size, &bits, Size);
+    }
+  }
+
+  template< >
+  inline void swapArray< 1 >(uint8_t* dst, const uint8_t* src, uint32_t count)
+  {
+    if(dst != src)
+    {
+      memcpy(dst, src, count);
+    }
+  }
+
+  /**
+   * \brief Copy count scalars of type T between a stream buffer and memory, reversing the bytes of
+   * each one if swap is set.
+   *
+   * Stream buffers are packed, so either side may be unaligned. The straight copy is a single
+   * memcpy, which libc already does with the widest loads the CPU allows; the swapped one uses
+   * unaligned NEON or SSE2 loads and never dereferences a misaligned T, so it is safe on ARM too.
+   */
+  template< typename T >
+  inline void copyArray(void* dst, const void* src, uint32_t count,
+                        bool swap = false)
+  {
+    if(count == 0)
+    {
+      return;
+    }
+
+    if(swap)
+    {
+      swapArray< sizeof(T) >(static_cast< uint8_t* >(dst),
+                             static_cast< const uint8_t* >(src), count);
+    }
+    else
+    {
+      memcpy(dst, src, count * sizeof(T));
+    }
+  }
+
+}
+
+#endif /* _ARRAY_COPY_H_ */
@@ -2,7 +2,9 @@
 #define _SERIALIZATION_H_
 
 #include "../Common/MessageTraits.h"
+#include "../Common/ContainerTraits.h"
 #include "SerializedMessage.h"
+#include "ArrayCopy.h"
 
 #include <vector>
 #include <map>
@@ -11,8 +13,10 @@
 #include <boost/call_traits.hpp>
 #include <boost/utility/enable_if.hpp>
 #include <boost/mpl/and.hpp>
+#include <boost/mpl/if.hpp>
 #include <boost/mpl/or.hpp>
 #include <boost/mpl/not.hpp>
+#include <boost/type_traits/is_arithmetic.hpp>
 
 #include <cstring>
 
@@ -32,26 +36,26 @@
  \endverbatim
  *
  * The only guarantee given is that Stream::next(T) is defined.
+ *
+ * Messages declared IsSimple skip allInOne and are copied in one piece, see AllInOneSerializer.
  */
 #define DECLARE_ALLINONE_SERIALIZER \
   template<typename Stream, typename T> \
   inline static void write(Stream& stream, const T& t) \
   { \
-    allInOne<Stream, const T&>(stream, t); \
+    NS_NaviCommon::AllInOneSerializer<T>::write(stream, t); \
   } \
   \
   template<typename Stream, typename T> \
   inline static void read(Stream& stream, T& t) \
   { \
-    allInOne<Stream, T&>(stream, t); \
+    NS_NaviCommon::AllInOneSerializer<T>::read(stream, t); \
   } \
   \
   template<typename T> \
   inline static uint32_t serializedLength(const T& t) \
   { \
-    LStream stream; \
-    allInOne<LStream, const T&>(stream, t); \
-    return stream.getLength(); \
+    return NS_NaviCommon::AllInOneSerializer<T>::serializedLength(t); \
   }
 
 namespace NS_NaviCommon
@@ -138,6 +142,22 @@ namespace NS_NaviCommon
     return Serializer< T >::serializedLength(t);
   }
 
+  struct ByteSwappedIStream;
+
+  /**
+   * \brief Whether a stream holds data of the other byte order, its scalars are swapped as they
+   * are read
+   */
+  template< typename Stream >
+  struct SwapsBytes: public FalseType
+  {
+  };
+
+  template< >
+  struct SwapsBytes< ByteSwappedIStream > : public TrueType
+  {
+  };
+
 #define CREATE_SIMPLE_SERIALIZER(Type) \
   template<> struct Serializer<Type> \
   { \
@@ -149,6 +169,10 @@ namespace NS_NaviCommon
     template<typename Stream> inline static void read(Stream& stream, Type& v) \
     { \
       v = *reinterpret_cast<Type*>(stream.advance(sizeof(v))); \
+      if(SwapsBytes<Stream>::value) \
+      { \
+        v = byteSwap(v); \
+      } \
     } \
     \
     inline static uint32_t serializedLength(const Type&) \
@@ -168,6 +192,10 @@ namespace NS_NaviCommon
     template<typename Stream> inline static void read(Stream& stream, Type& v) \
     { \
       memcpy(&v, stream.advance(sizeof(v)), sizeof(v) ); \
+      if(SwapsBytes<Stream>::value) \
+      { \
+        v = byteSwap(v); \
+      } \
     } \
     \
     inline static uint32_t serializedLength(const Type&) \
@@ -335,6 +363,123 @@ namespace NS_NaviCommon
     }
   };
 
+  /*
+   * serialize [first, last) into, or deserialize it from, a block of len bytes already claimed
+   * from a stream, defined below with the streams. The block is read in the byte order of Stream
+   */
+  template< typename Iterator >
+  inline void packBlock(uint8_t* data, uint32_t len, Iterator first, Iterator last);
+
+  template< typename Stream, typename Iterator >
+  inline void unpackBlock(uint8_t* data, uint32_t len, Iterator first, Iterator last);
+
+  /**
+   * \brief Copies arrays of simple elements between a stream and memory in one piece, used by
+   * the vector and array serializers. Scalars go through copyArray(), which swaps them when the
+   * stream holds the other byte order
+   */
+  template< typename T, typename Stream, class Enabled = void >
+  struct ElementCopy
+  {
+    inline static void write(Stream& stream, const T* src, uint32_t count)
+    {
+      copyArray< T >(stream.advance(count * (uint32_t)sizeof(T)), src, count);
+    }
+
+    inline static void read(Stream& stream, T* dst, uint32_t count)
+    {
+      copyArray< T >(dst, stream.advance(count * (uint32_t)sizeof(T)), count,
+                     SwapsBytes< Stream >::value);
+    }
+  };
+
+  /**
+   * \brief ElementCopy specialized for simple messages, copied whole; from a stream of the other
+   * byte order they are read field by field
+   */
+  template< typename T, typename Stream >
+  struct ElementCopy< T, Stream,
+      typename boost::disable_if< boost::is_arithmetic< T > >::type >
+  {
+    inline static void write(Stream& stream, const T* src, uint32_t count)
+    {
+      const uint32_t data_len = count * (uint32_t)sizeof(T);
+      memcpy(stream.advance(data_len), src, data_len);
+    }
+
+    inline static void read(Stream& stream, T* dst, uint32_t count)
+    {
+      if(SwapsBytes< Stream >::value)
+      {
+        for(uint32_t i = 0; i < count; ++i)
+        {
+          stream.next(dst[i]);
+        }
+        return;
+      }
+
+      const uint32_t data_len = count * (uint32_t)sizeof(T);
+      memcpy(static_cast< void* >(dst), stream.advance(data_len), data_len);
+    }
+  };
+
+  template< typename T, typename Stream >
+  inline void writeElements(Stream& stream, const T* src, uint32_t count)
+  {
+    ElementCopy< T, Stream >::write(stream, src, count);
+  }
+
+  template< typename T, typename Stream >
+  inline void readElements(Stream& stream, T* dst, uint32_t count)
+  {
+    ElementCopy< T, Stream >::read(stream, dst, count);
+  }
+
+  /*
+   * writeElements() and readElements() for arrays whose length N is known at compile time. GCC
+   * turns a memcpy of a large constant length into rep movs on x86, which is several times
+   * slower than the vector loop that a copy per element compiles to
+   */
+  template< size_t N, typename T, typename Stream >
+  inline void writeFixedElements(Stream& stream, const T* src)
+  {
+    uint8_t* dst = stream.advance((uint32_t)(N * sizeof(T)));
+    for(size_t i = 0; i < N; ++i)
+    {
+      memcpy(dst + i * sizeof(T), &src[i], sizeof(T));
+    }
+  }
+
+  template< size_t N, typename T, typename Stream >
+  inline void readFixedElements(Stream& stream, T* dst)
+  {
+    if(SwapsBytes< Stream >::value)
+    {
+      readElements(stream, dst, (uint32_t)N);
+      return;
+    }
+
+    const uint8_t* src = stream.advance((uint32_t)(N * sizeof(T)));
+    for(size_t i = 0; i < N; ++i)
+    {
+      memcpy(static_cast< void* >(&dst[i]), src + i * sizeof(T), sizeof(T));
+    }
+  }
+
+  /**
+   * \brief Resizes a vector of messages or strings being deserialized, the new elements are
+   * value-initialized. Containers whose allocator has no default constructor, like those of a
+   * managed segment, specialize it to build them with the allocator of the vector
+   */
+  template< typename VecType >
+  struct VectorResize
+  {
+    inline static void resize(VecType& v, uint32_t len)
+    {
+      v.resize(len);
+    }
+  };
+
   /**
    * \brief Vector serializer.  Default implementation does nothing
    */
@@ -350,8 +495,7 @@ namespace NS_NaviCommon
   struct VectorSerializer< T, ContainerAllocator,
       typename boost::disable_if< NS_NaviCommon::IsFixedSize< T > >::type >
   {
-    typedef std::vector< T,
-        typename ContainerAllocator::template rebind< T >::other > VecType;
+    typedef typename ContainerVector< T, ContainerAllocator >::Type VecType;
     typedef typename VecType::iterator IteratorType;
     typedef typename VecType::const_iterator ConstIteratorType;
 
@@ -372,7 +516,7 @@ namespace NS_NaviCommon
     {
       uint32_t len;
       stream.next(len);
-      v.resize(len);
+      VectorResize< VecType >::resize(v, len);
       IteratorType it = v.begin();
       IteratorType end = v.end();
       for(; it != end; ++it)
@@ -402,8 +546,7 @@ namespace NS_NaviCommon
   struct VectorSerializer< T, ContainerAllocator,
       typename boost::enable_if< NS_NaviCommon::IsSimple< T > >::type >
   {
-    typedef std::vector< T,
-        typename ContainerAllocator::template rebind< T >::other > VecType;
+    typedef typename ContainerVector< T, ContainerAllocator >::Type VecType;
     typedef typename VecType::iterator IteratorType;
     typedef typename VecType::const_iterator ConstIteratorType;
 
@@ -414,8 +557,7 @@ namespace NS_NaviCommon
       stream.next(len);
       if(!v.empty())
       {
-        const uint32_t data_len = len * (uint32_t)sizeof(T);
-        memcpy(stream.advance(data_len), &v.front(), data_len);
+        writeElements(stream, &v.front(), len);
       }
     }
 
@@ -428,8 +570,7 @@ namespace NS_NaviCommon
 
       if(len > 0)
       {
-        const uint32_t data_len = (uint32_t)sizeof(T) * len;
-        memcpy(&v.front(), stream.advance(data_len), data_len);
+        readElements(stream, &v.front(), len);
       }
     }
 
@@ -440,7 +581,12 @@ namespace NS_NaviCommon
   };
 
   /**
-   * \brief Vector serializer, specialized for fixed-size non-simple types
+   * \brief Vector serializer, specialized for fixed-size non-simple types.
+   *
+   * Their fields are not laid out in memory as they are serialized (padding, members of other
+   * sizes), so each element still walks its fields; but all elements have the same length, so the
+   * block of the whole vector is claimed from the stream at once and the elements are packed into
+   * it without checking or growing the stream for each of them.
    */
   template< typename T, class ContainerAllocator >
   struct VectorSerializer< T, ContainerAllocator,
@@ -448,21 +594,22 @@ namespace NS_NaviCommon
           mpl::and_< NS_NaviCommon::IsFixedSize< T >,
               mpl::not_< NS_NaviCommon::IsSimple< T > > > >::type >
   {
-    typedef std::vector< T,
-        typename ContainerAllocator::template rebind< T >::other > VecType;
+    typedef typename ContainerVector< T, ContainerAllocator >::Type VecType;
     typedef typename VecType::iterator IteratorType;
     typedef typename VecType::const_iterator ConstIteratorType;
 
     template< typename Stream >
     inline static void write(Stream& stream, const VecType& v)
     {
-      stream.next((uint32_t)v.size());
-      ConstIteratorType it = v.begin();
-      ConstIteratorType end = v.end();
-      for(; it != end; ++it)
+      uint32_t len = (uint32_t)v.size();
+      stream.next(len);
+      if(v.empty())
       {
-        stream.next(*it);
+        return;
       }
+
+      const uint32_t data_len = len * serializationLength(v.front());
+      packBlock(stream.advance(data_len), data_len, v.begin(), v.end());
     }
 
     template< typename Stream >
@@ -470,13 +617,14 @@ namespace NS_NaviCommon
     {
       uint32_t len;
       stream.next(len);
-      v.resize(len);
-      IteratorType it = v.begin();
-      IteratorType end = v.end();
-      for(; it != end; ++it)
+      VectorResize< VecType >::resize(v, len);
+      if(len == 0)
       {
-        stream.next(*it);
+        return;
       }
+
+      const uint32_t data_len = len * serializationLength(v.front());
+      unpackBlock< Stream >(stream.advance(data_len), data_len, v.begin(), v.end());
     }
 
     inline static uint32_t serializedLength(const VecType& v)
@@ -591,15 +739,13 @@ namespace NS_NaviCommon
     template< typename Stream >
     inline static void write(Stream& stream, const ArrayType& v)
     {
-      const uint32_t data_len = N * sizeof(T);
-      memcpy(stream.advance(data_len), &v.front(), data_len);
+      writeFixedElements< N >(stream, &v.front());
     }
 
     template< typename Stream >
     inline static void read(Stream& stream, ArrayType& v)
     {
-      const uint32_t data_len = N * sizeof(T);
-      memcpy(&v.front(), stream.advance(data_len), data_len);
+      readFixedElements< N >(stream, &v.front());
     }
 
     inline static uint32_t serializedLength(const ArrayType&)
@@ -676,6 +822,95 @@ namespace NS_NaviCommon
     return ArraySerializer< T, N >::serializedLength(t);
   }
 
+  /**
+   * \brief C array serializer, default implementation serializes element by element
+   */
+  template< typename T, size_t N, class Enabled = void >
+  struct CArraySerializer
+  {
+    template< typename Stream >
+    inline static void write(Stream& stream, const T (&v)[N])
+    {
+      for(size_t i = 0; i < N; ++i)
+      {
+        stream.next(v[i]);
+      }
+    }
+
+    template< typename Stream >
+    inline static void read(Stream& stream, T (&v)[N])
+    {
+      for(size_t i = 0; i < N; ++i)
+      {
+        stream.next(v[i]);
+      }
+    }
+
+    inline static uint32_t serializedLength(const T (&v)[N])
+    {
+      uint32_t size = 0;
+      for(size_t i = 0; i < N; ++i)
+      {
+        size += serializationLength(v[i]);
+      }
+
+      return size;
+    }
+  };
+
+  /**
+   * \brief C array serializer, specialized for scalars and simple types
+   */
+  template< typename T, size_t N >
+  struct CArraySerializer< T, N,
+      typename boost::enable_if<
+          mpl::or_< boost::is_arithmetic< T >, NS_NaviCommon::IsSimple< T > > >::type >
+  {
+    template< typename Stream >
+    inline static void write(Stream& stream, const T (&v)[N])
+    {
+      writeFixedElements< N >(stream, v);
+    }
+
+    template< typename Stream >
+    inline static void read(Stream& stream, T (&v)[N])
+    {
+      readFixedElements< N >(stream, v);
+    }
+
+    inline static uint32_t serializedLength(const T (&)[N])
+    {
+      return N * sizeof(T);
+    }
+  };
+
+  /**
+   * \brief serialize version for C arrays
+   */
+  template< typename T, size_t N, typename Stream >
+  inline void serialize(Stream& stream, const T (&t)[N])
+  {
+    CArraySerializer< T, N >::write(stream, t);
+  }
+
+  /**
+   * \brief deserialize version for C arrays
+   */
+  template< typename T, size_t N, typename Stream >
+  inline void deserialize(Stream& stream, T (&t)[N])
+  {
+    CArraySerializer< T, N >::read(stream, t);
+  }
+
+  /**
+   * \brief serializationLength version for C arrays
+   */
+  template< typename T, size_t N >
+  inline uint32_t serializationLength(const T (&t)[N])
+  {
+    return CArraySerializer< T, N >::serializedLength(t);
+  }
+
   /**
    * \brief Enum
    */
@@ -771,6 +1006,36 @@ namespace NS_NaviCommon
     }
   };
 
+  /**
+   * \brief Input stream over data serialized on a machine of the other byte order, e.g. a log
+   * recorded on another architecture. Scalars are swapped as they are read, arrays of them in bulk
+   * by copyArray(); simple messages are read field by field instead of copied whole.
+   */
+  struct ByteSwappedIStream: public IStream
+  {
+    ByteSwappedIStream(uint8_t* data, uint32_t count)
+        : IStream(data, count)
+    {
+    }
+
+    /**
+     * \brief Deserialize an item from this input stream
+     */
+    template< typename T >
+    void next(T& t)
+    {
+      deserialize(*this, t);
+    }
+
+    template< typename T >
+    ByteSwappedIStream&
+    operator>>(T& t)
+    {
+      deserialize(*this, t);
+      return *this;
+    }
+  };
+
   /**
    * \brief Output stream
    */
@@ -801,6 +1066,139 @@ namespace NS_NaviCommon
     }
   };
 
+  template< typename Iterator >
+  inline void packBlock(uint8_t* data, uint32_t len, Iterator first,
+                        Iterator last)
+  {
+    OStream block(data, len);
+    for(; first != last; ++first)
+    {
+      block.next(*first);
+    }
+  }
+
+  template< typename Stream, typename Iterator >
+  inline void unpackBlock(uint8_t* data, uint32_t len, Iterator first,
+                          Iterator last)
+  {
+    typename mpl::if_c< SwapsBytes< Stream >::value, ByteSwappedIStream,
+        IStream >::type block(data, len);
+    for(; first != last; ++first)
+    {
+      block.next(*first);
+    }
+  }
+
+  /**
+   * \brief Output stream for a message of unknown length, written in a single pass instead of
+   * measuring it with serializationLength() first.
+   *
+   * It writes into the buffer it was given, typically the free space of a shared segment. Once
+   * that is full it moves what was written so far into a buffer of its own and goes on there,
+   * growing it as needed; the caller then makes room and copies it back. A pointer returned by
+   * advance() is only valid until the next write.
+   */
+  struct GrowableOStream
+  {
+    static const StreamType stream_type = stream_types::Output;
+
+    GrowableOStream(uint8_t* data = NULL, uint32_t capacity = 0)
+        : data_(data), capacity_(capacity), length_(0), spilled_(false)
+    {
+    }
+
+    /**
+     * \brief Serialize an item to this output stream
+     */
+    template< typename T >
+    void next(const T& t)
+    {
+      serialize(*this, t);
+    }
+
+    template< typename T >
+    GrowableOStream&
+    operator<<(const T& t)
+    {
+      serialize(*this, t);
+      return *this;
+    }
+
+    /**
+     * \brief Advances the stream, growing it when the buffer is full, and returns a pointer to
+     * the position before it was advanced
+     */
+    inline uint8_t*
+    advance(uint32_t len)
+    {
+      uint32_t old_length = length_;
+      length_ += len;
+      if(length_ > capacity_)
+      {
+        grow(old_length);
+      }
+      return data_ + old_length;
+    }
+
+    /**
+     * \brief Returns the number of bytes written
+     */
+    inline uint32_t size() const
+    {
+      return length_;
+    }
+
+    /**
+     * \brief Returns the bytes written, in the buffer given to the constructor unless spilled()
+     */
+    inline const uint8_t*
+    data() const
+    {
+      return data_;
+    }
+
+    /**
+     * \brief Returns whether the message outgrew the buffer given to the constructor
+     */
+    inline bool spilled() const
+    {
+      return spilled_;
+    }
+
+  private:
+    void grow(uint32_t written)
+    {
+      size_t capacity = spill_.size() * 2;
+      if(capacity < 4096)
+      {
+        capacity = 4096;
+      }
+      while(capacity < length_)
+      {
+        capacity *= 2;
+      }
+
+      spill_.resize(capacity);
+      if(!spilled_)
+      {
+        if(written > 0)
+        {
+          memcpy(&spill_[0], data_, written);
+        }
+        spilled_ = true;
+      }
+
+      data_ = &spill_[0];
+      capacity_ = (uint32_t)capacity;
+    }
+
+    uint8_t* data_;
+    uint32_t capacity_;
+    uint32_t length_;
+    bool spilled_;
+    std::vector< uint8_t > spill_;
+  };
+
   /**
    * \brief Length stream
    *
@@ -847,6 +1245,346 @@ namespace NS_NaviCommon
     uint32_t count_;
   };
 
+  /**
+   * \brief Serialization of the messages declared with DECLARE_ALLINONE_SERIALIZER, the default
+   * implementation walks their fields through allInOne
+   */
+  template< typename M, class Enabled = void >
+  struct AllInOneSerializer
+  {
+    template< typename Stream >
+    inline static void write(Stream& stream, const M& m)
+    {
+      Serializer< M >::template allInOne< Stream, const M& >(stream, m);
+    }
+
+    template< typename Stream >
+    inline static void read(Stream& stream, M& m)
+    {
+      Serializer< M >::template allInOne< Stream, M& >(stream, m);
+    }
+
+    inline static uint32_t serializedLength(const M& m)
+    {
+      LStream stream;
+      Serializer< M >::template allInOne< LStream, const M& >(stream, m);
+      return stream.getLength();
+    }
+  };
+
+  /**
+   * \brief AllInOneSerializer specialized for simple messages, they are laid out in memory as
+   * they are serialized so a single memcpy reads or writes them and their length is known at
+   * compile time
+   */
+  template< typename M >
+  struct AllInOneSerializer< M,
+      typename boost::enable_if< NS_NaviCommon::IsSimple< M > >::type >
+  {
+    static const uint32_t length = sizeof(M);
+
+    template< typename Stream >
+    inline static void write(Stream& stream, const M& m)
+    {
+      memcpy(stream.advance(length), &m, length);
+    }
+
+    template< typename Stream >
+    inline static void read(Stream& stream, M& m)
+    {
+      if(SwapsBytes< Stream >::value)
+      {
+        Serializer< M >::template allInOne< Stream, M& >(stream, m);
+        return;
+      }
+
+      memcpy(static_cast< void* >(&m), stream.advance(length), length);
+    }
+
+    inline static uint32_t serializedLength(const M&)
+    {
+      return length;
+    }
+  };
+
+  /**
+   * \brief AllInOneSerializer specialized for fixed-size, non-simple messages: every message of
+   * the type has the same length, so it is measured once
+   */
+  template< typename M >
+  struct AllInOneSerializer< M,
+      typename boost::enable_if<
+          mpl::and_< NS_NaviCommon::IsFixedSize< M >,
+              mpl::not_< NS_NaviCommon::IsSimple< M > > > >::type >
+  {
+    template< typename Stream >
+    inline static void write(Stream& stream, const M& m)
+    {
+      Serializer< M >::template allInOne< Stream, const M& >(stream, m);
+    }
+
+    template< typename Stream >
+    inline static void read(Stream& stream, M& m)
+    {
+      Serializer< M >::template allInOne< Stream, M& >(stream, m);
+    }
+
+    inline static uint32_t serializedLength(const M& m)
+    {
+      static const uint32_t length = measure(m);
+      return length;
+    }
+
+  private:
+    static uint32_t measure(const M& m)
+    {
+      LStream stream;
+      Serializer< M >::template allInOne< LStream, const M& >(stream, m);
+      return stream.getLength();
+    }
+  };
+
+  /**
+   * \brief Read-only view over a serialized array of simple elements, it points
+   * into the buffer of the stream it was read from instead of copying it.
+   *
+   * Elements are not necessarily aligned in the buffer, operator[] copies them
+   * out so it is safe on ARM as well. Elements of the other byte order are
+   * swapped as they are copied out.
+   */
+  template< typename T >
+  class ArrayView
+  {
+  public:
+    ArrayView()
+        : data_(NULL), size_(0), swapped_(false)
+    {
+    }
+
+    ArrayView(const uint8_t* data, uint32_t size, bool swapped = false)
+        : data_(data), size_(size), swapped_(swapped)
+    {
+    }
+
+    inline uint32_t size() const
+    {
+      return size_;
+    }
+
+    inline bool empty() const
+    {
+      return size_ == 0;
+    }
+
+    inline const uint8_t*
+    data() const
+    {
+      return data_;
+    }
+
+    inline T operator[](uint32_t index) const
+    {
+      T value;
+      if(swapped_)
+      {
+        ByteSwappedIStream element(
+            const_cast< uint8_t* >(data_ + index * sizeof(T)), sizeof(T));
+        element.next(value);
+        return value;
+      }
+
+      memcpy(static_cast< void* >(&value), data_ + index * sizeof(T),
+             sizeof(T));
+      return value;
+    }
+
+    template< class ContainerAllocator >
+    void copyTo(std::vector< T, ContainerAllocator >& v) const
+    {
+      v.resize(size_);
+      if(size_ == 0)
+      {
+        return;
+      }
+
+      if(swapped_)
+      {
+        ByteSwappedIStream elements(const_cast< uint8_t* >(data_),
+                                    size_ * (uint32_t)sizeof(T));
+        readElements(elements, &v.front(), size_);
+        return;
+      }
+
+      memcpy(static_cast< void* >(&v.front()), data_, size_ * sizeof(T));
+    }
+
+  private:
+    const uint8_t* data_;
+    uint32_t size_;
+    bool swapped_;
+  };
+
+  /**
+   * \brief Writable window over an array reserved in place in an output buffer
+   */
+  template< typename T >
+  class ArraySpan
+  {
+  public:
+    ArraySpan()
+        : data_(NULL), size_(0)
+    {
+    }
+
+    ArraySpan(uint8_t* data, uint32_t size)
+        : data_(data), size_(size)
+    {
+    }
+
+    inline uint32_t size() const
+    {
+      return size_;
+    }
+
+    inline uint8_t*
+    data() const
+    {
+      return data_;
+    }
+
+    inline void set(uint32_t index, const T& value)
+    {
+      memcpy(data_ + index * sizeof(T), &value, sizeof(T));
+    }
+
+    inline T get(uint32_t index) const
+    {
+      T value;
+      memcpy(&value, data_ + index * sizeof(T), sizeof(T));
+      return value;
+    }
+
+  private:
+    uint8_t* data_;
+    uint32_t size_;
+  };
+
+  /**
+   * \brief Read the length prefix of a simple-element array and return a view
+   * over its elements, the stream is advanced past the array. A view read from
+   * a ByteSwappedIStream swaps the elements it hands out.
+   */
+  template< typename T, typename Stream >
+  inline ArrayView< T > readArrayView(Stream& stream)
+  {
+    uint32_t len;
+    stream.next(len);
+    return ArrayView< T >(stream.advance(len * (uint32_t)sizeof(T)), len,
+                          SwapsBytes< Stream >::value);
+  }
+
+  /**
+   * \brief Write the length prefix of a simple-element array and reserve its
+   * elements in place, to be filled through the returned span.
+   */
+  template< typename T >
+  inline ArraySpan< T > writeArraySpan(OStream& stream, uint32_t len)
+  {
+    stream.next(len);
+    return ArraySpan< T >(stream.advance(len * (uint32_t)sizeof(T)), len);
+  }
+
+  /**
+   * \brief Serialized length of a simple-element array of len elements
+   */
+  template< typename T >
+  inline uint32_t arraySerializationLength(uint32_t len)
+  {
+    return 4 + len * (uint32_t)sizeof(T);
+  }
+
+  /**
+   * \brief Decode a simple field at data, a position remembered by a message view; data need
+   * not be aligned
+   */
+  template< typename T >
+  inline T readField(const uint8_t* data)
+  {
+    T value;
+    memcpy(static_cast< void* >(&value), data, sizeof(T));
+    return value;
+  }
+
+  /**
+   * \brief Base of the lazy views over a serialized message of type M, e.g. OccupancyGridView.
+   *
+   * A view is built from an input stream: it walks the message only as far as needed to find its
+   * fields, skipping arrays and strings by their length prefix, and leaves the stream behind the
+   * message. Fields are decoded when they are asked for, arrays are handed out as ArrayView, and
+   * materialize() deserializes the whole message. A view points into the buffer of the stream and
+   * is only valid as long as that, for a ViewSubscriber during the callback.
+   */
+  template< typename M >
+  class MessageView
+  {
+  public:
+    /**
+     * \brief Whether the view was built over a message
+     */
+    inline bool valid() const
+    {
+      return data_ != NULL;
+    }
+
+    /**
+     * \brief The serialized message
+     */
+    inline const uint8_t*
+    data() const
+    {
+      return data_;
+    }
+
+    inline uint32_t length() const
+    {
+      return length_;
+    }
+
+    /**
+     * \brief Deserialize the whole message into m
+     */
+    void materialize(M& m) const
+    {
+      IStream stream(data_, length_);
+      deserialize(stream, m);
+    }
+
+  protected:
+    MessageView()
+        : data_(NULL), length_(0)
+    {
+    }
+
+    /*
+     * the message starts at the position of stream
+     */
+    void start(IStream& stream)
+    {
+      data_ = stream.getData();
+    }
+
+    /*
+     * the message ends at the position of stream
+     */
+    void finish(IStream& stream)
+    {
+      length_ = (uint32_t)(stream.getData() - data_);
+    }
+
+    uint8_t* data_;
+    uint32_t length_;
+  };
+
   /**
    * \brief Serialize a message
    */
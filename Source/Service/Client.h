@@ -11,7 +11,12 @@
 #include <boost/interprocess/shared_memory_object.hpp>
 #include <boost/interprocess/mapped_region.hpp>
 #include <boost/interprocess/sync/scoped_lock.hpp>
+#include <list>
+#include <set>
 #include "Service.h"
+#include "ServiceCall.h"
+#include "../Common/SharedSegment.h"
+#include "../Thread/RemapLock.h"
 #include "../Console/Console.h"
 #include "../Serialization/Serialization.h"
 
@@ -24,102 +29,656 @@ namespace NS_Service
   class Client
   {
   public:
+    typedef typename ServiceCall< SrvType >::Ptr CallPtr;
+    typedef typename ServiceCall< SrvType >::CompletionCallback CompletionCallback;
+
     Client(std::string name)
     {
       service_name = name;
       operation = NULL;
+      rejected = false;
+      timeout = SERVICE_DEFAULT_TIMEOUT;
+      completion_active = false;
+      for(uint32_t i = 0; i < SERVICE_SLOTS; i++)
+      {
+        srv_segments[i].setName(serviceArenaName(service_name, i));
+      }
       obtainOper();
     }
 
     virtual ~Client()
     {
+      if(completion_active)
+      {
+        {
+          boost::mutex::scoped_lock lock(calls_lock);
+          completion_active = false;
+        }
+        if(operation)
+        {
+          operation->rep_event.notify();
+        }
+        completion_thread.join();
+      }
 
+      /*
+       * completions still queued would call back into a client that is gone
+       */
+      std::set< NS_NaviCommon::CallbackQueueInterface* >::iterator it;
+      for(it = completion_queues.begin(); it != completion_queues.end(); ++it)
+      {
+        (*it)->removeByID((unsigned long)this);
+      }
     }
   private:
     std::string service_name;
 
     ServiceOperation* operation;
 
+    /*
+     * set once the service turned out to be of another type, the client
+     * stays detached then
+     */
+    bool rejected;
+
     mapped_region oper_region;
-    mapped_region srv_region;
 
-    void obtainOper()
+    /*
+     * mapped by whichever thread owns the matching slot
+     */
+    NS_NaviCommon::SharedSegment srv_segments[SERVICE_SLOTS];
+
+    unsigned long timeout;
+
+    /*
+     * held shared by every call while it uses operation and the arenas,
+     * and exclusively to map them again
+     */
+    NS_NaviCommon::RemapLock attach_lock;
+
+    /*
+     * calls of callAsync() not done yet, finished by the completion thread
+     */
+    boost::mutex calls_lock;
+    std::list< CallPtr > async_calls;
+    boost::thread completion_thread;
+    bool completion_active;
+
+    /*
+     * queues given to callAsync(), completions are posted there under the
+     * client's address as owner id
+     */
+    std::set< NS_NaviCommon::CallbackQueueInterface* > completion_queues;
+
+    enum
     {
-      shared_memory_object oper_shm;
+      NO_FREE_SLOT = -1,
+      REQUEST_FAILED = -2,
+    };
 
+    void obtainOper()
+    {
       try
       {
-        oper_shm = shared_memory_object(open_only, service_name.c_str(),
-                                        read_write);
+        operation = attachService(service_name, oper_region, false);
       }
       catch(interprocess_exception& exception)
+      {
+        operation = NULL;
+      }
+
+      if(!operation)
       {
         return;
       }
 
-      offset_t oper_size = 0;
-      if(oper_shm.get_size(oper_size) && oper_size == sizeof(ServiceOperation))
+      scoped_lock< NS_NaviCommon::SharedMutex > lock(operation->lock);
+
+      NS_NaviCommon::TypeSignature signature =
+          NS_NaviCommon::typeSignature< SrvType >();
+      if(NS_NaviCommon::typeBound(operation->type)
+          && !NS_NaviCommon::sameType(operation->type, signature))
+      {
+        printf("service %s serves %s, can not call it as %s!\n",
+               service_name.c_str(), operation->type.name, signature.name);
+        operation = NULL;
+        rejected = true;
+      }
+    }
+
+    /*
+     * attach again if the watchdog retired the service, a server starting
+     * later creates a new one. Returns with use holding attach_lock, the
+     * old mapping is only dropped once no call is using it
+     */
+    bool attached(boost::shared_lock< NS_NaviCommon::RemapLock >& use)
+    {
+      use.lock();
+      if(operation ?
+          NS_NaviCommon::atomicLoad(&operation->magic) == SERVICE_MAGIC :
+          rejected)
+      {
+        return operation != NULL;
+      }
+
+      /*
+       * wake the calls waiting on the retired service, they find the
+       * server gone and let go of it
+       */
+      if(operation)
       {
-        oper_region = mapped_region(oper_shm, read_write);
+        operation->rep_event.notify();
+      }
+      use.unlock();
+
+      {
+        boost::unique_lock< NS_NaviCommon::RemapLock > lock(attach_lock);
+
+        if(operation
+            && NS_NaviCommon::atomicLoad(&operation->magic) != SERVICE_MAGIC)
+        {
+          operation = NULL;
+          for(uint32_t i = 0; i < SERVICE_SLOTS; i++)
+          {
+            srv_segments[i].unmap();
+          }
+        }
 
-        void* region_addr = oper_region.get_address();
-        if(region_addr)
+        if(!operation && !rejected)
         {
-          operation = static_cast< ServiceOperation* >(region_addr);
+          obtainOper();
         }
       }
+
+      use.lock();
+      return operation != NULL;
     }
 
-  public:
-    bool call(SrvType& srv)
+    /*
+     * deadline of one wait for a reply: the call deadline, but no later
+     * than one heartbeat period so a server that died is noticed
+     */
+    static uint64_t waitDeadline(uint64_t deadline)
     {
-      if(!operation)
+      uint64_t period = NS_NaviCommon::SharedEvent::deadline(
+          NS_NaviCommon::HEARTBEAT_PERIOD);
+      if(!deadline || period < deadline)
+      {
+        return period;
+      }
+
+      return deadline;
+    }
+
+    /*
+     * called with the lock held
+     */
+    int freeSlot()
+    {
+      for(uint32_t i = 0; i < SERVICE_SLOTS; i++)
       {
-        obtainOper();
-        if(!operation)
+        if(operation->slots[i].status == SERVICE_SLOT_FREE)
         {
-          return false;
+          return i;
+        }
+      }
+      return -1;
+    }
+
+    void releaseSlot(ServiceSlot& slot)
+    {
+      slot.status = SERVICE_SLOT_FREE;
+      operation->rep_event.notify();
+    }
+
+    /*
+     * claim a free slot and issue srv as its request; the claimed slot is
+     * ours, so the request is written unlocked. Cached calls send no
+     * request, their reply does not depend on it. Returns the slot, or
+     * NO_FREE_SLOT / REQUEST_FAILED
+     */
+    int request(scoped_lock< NS_NaviCommon::SharedMutex >& lock, const SrvType& srv,
+                uint64_t* version = NULL)
+    {
+      int index = freeSlot();
+      if(index < 0)
+      {
+        return NO_FREE_SLOT;
+      }
+
+      ServiceSlot& slot = operation->slots[index];
+      NS_NaviCommon::SharedSegment& srv_segment = srv_segments[index];
+      slot.status = SERVICE_SLOT_CLAIMED;
+      slot.id = ++operation->next_id;
+      slot.client_pid = NS_NaviCommon::currentProcess();
+      slot.version = version ? *version : 0;
+      slot.req_len = 0;
+
+      bool reserved = true;
+      if(!version)
+      {
+        lock.unlock();
+
+        size_t length;
+        reserved = writeArena(srv_segment, slot, srv, length);
+        if(reserved)
+        {
+          slot.req_len = length;
+        }
+
+        lock.lock();
+      }
+
+      if(!reserved)
+      {
+        releaseSlot(slot);
+        return REQUEST_FAILED;
+      }
+
+      slot.stamp = NS_NaviCommon::SharedEvent::now();
+      slot.status = SERVICE_SLOT_REQUESTED;
+      NS_NaviCommon::recordPublish(operation->statistics);
+      notifyServer(operation);
+
+      return index;
+    }
+
+    /*
+     * read the reply of an answered slot into srv and free the slot, srv
+     * is left alone when the server reports it not modified
+     */
+    bool reply(scoped_lock< NS_NaviCommon::SharedMutex >& lock, int index,
+               SrvType& srv, uint64_t* version = NULL)
+    {
+      ServiceSlot& slot = operation->slots[index];
+      NS_NaviCommon::SharedSegment& srv_segment = srv_segments[index];
+
+      if(version)
+      {
+        *version = slot.version;
+      }
+
+      if(!slot.modified)
+      {
+        releaseSlot(slot);
+        return true;
+      }
+
+      lock.unlock();
+
+      bool replied = slot.buf_len
+          && srv_segment.sync(slot.capacity, slot.generation);
+      if(replied)
+      {
+        NS_NaviCommon::IStream stream(srv_segment.getAddress(), slot.buf_len);
+
+        NS_NaviCommon::deserialize(stream, srv);
+      }
+
+      lock.lock();
+      releaseSlot(slot);
+
+      return replied;
+    }
+
+    /*
+     * a request no worker has taken yet is withdrawn, one in progress is
+     * left to the worker to free
+     */
+    void giveUp(int index)
+    {
+      ServiceSlot& slot = operation->slots[index];
+
+      if(slot.status == SERVICE_SLOT_REQUESTED)
+      {
+        releaseSlot(slot);
+      }
+      else
+      {
+        slot.status = SERVICE_SLOT_ABANDONED;
+      }
+      NS_NaviCommon::recordTimeout(operation->statistics);
+    }
+
+    static bool expired(uint64_t deadline, uint64_t current)
+    {
+      return deadline && current >= deadline;
+    }
+
+    /*
+     * serving is the service the pending calls were issued to. The thread
+     * holds attach_lock only while it looks at the slots, and wakes at
+     * least once a heartbeat period so a waiting re-attach goes ahead
+     */
+    void completer(ServiceOperation* serving)
+    {
+      std::list< CallPtr > done;
+      std::list< CallPtr > failed;
+      bool stopping = false;
+
+      while(!stopping)
+      {
+        bool detached = false;
+        {
+          boost::shared_lock< NS_NaviCommon::RemapLock > use(attach_lock);
+
+          /*
+           * the slots of calls issued before a re-attach belong to the
+           * retired service
+           */
+          bool moved = operation != serving;
+          serving = operation;
+
+          uint32_t seen = operation ? operation->rep_event.snapshot() : 0;
+
+          std::list< CallPtr > calls;
+          {
+            boost::mutex::scoped_lock lock(calls_lock);
+            stopping = !completion_active;
+            calls = async_calls;
+          }
+
+          if(stopping || !operation)
+          {
+            for(typename std::list< CallPtr >::iterator it = calls.begin();
+                it != calls.end(); it++)
+            {
+              if((*it)->slot >= 0 && operation && !moved)
+              {
+                scoped_lock< NS_NaviCommon::SharedMutex > lock(
+                    operation->lock);
+                giveUp((*it)->slot);
+              }
+              failed.push_back(*it);
+            }
+            detached = !operation;
+          }
+          else
+          {
+            uint64_t next_deadline = 0;
+            {
+              scoped_lock< NS_NaviCommon::SharedMutex > lock(operation->lock);
+
+              bool server = serverAlive(operation);
+              uint64_t current = NS_NaviCommon::SharedEvent::now();
+              for(typename std::list< CallPtr >::iterator it = calls.begin();
+                  it != calls.end(); it++)
+              {
+                const CallPtr& call = *it;
+
+                if(moved && call->slot >= 0)
+                {
+                  failed.push_back(call);
+                  continue;
+                }
+
+                if(call->slot < 0)
+                {
+                  int index = request(lock, call->srv);
+                  if(index == REQUEST_FAILED)
+                  {
+                    failed.push_back(call);
+                    continue;
+                  }
+                  call->slot = index;
+                }
+
+                if(call->slot >= 0
+                    && operation->slots[call->slot].status
+                        == SERVICE_SLOT_REPLIED)
+                {
+                  if(reply(lock, call->slot, call->srv))
+                  {
+                    done.push_back(call);
+                  }
+                  else
+                  {
+                    failed.push_back(call);
+                  }
+                  continue;
+                }
+
+                if(expired(call->deadline, current) || !server)
+                {
+                  if(call->slot >= 0)
+                  {
+                    giveUp(call->slot);
+                  }
+                  else
+                  {
+                    NS_NaviCommon::recordTimeout(operation->statistics);
+                  }
+                  failed.push_back(call);
+                  continue;
+                }
+
+                if(call->deadline
+                    && (!next_deadline || call->deadline < next_deadline))
+                {
+                  next_deadline = call->deadline;
+                }
+              }
+            }
+
+            if(done.empty() && failed.empty())
+            {
+              operation->rep_event.wait(seen, waitDeadline(next_deadline));
+              continue;
+            }
+          }
+        }
+
+        /*
+         * completions run unlocked, a callback may call the client again
+         */
+        if(!done.empty() || !failed.empty())
+        {
+          {
+            boost::mutex::scoped_lock lock(calls_lock);
+            for(typename std::list< CallPtr >::iterator it = done.begin();
+                it != done.end(); it++)
+            {
+              async_calls.remove(*it);
+            }
+            for(typename std::list< CallPtr >::iterator it = failed.begin();
+                it != failed.end(); it++)
+            {
+              async_calls.remove(*it);
+            }
+          }
+
+          for(typename std::list< CallPtr >::iterator it = done.begin();
+              it != done.end(); it++)
+          {
+            ServiceCall< SrvType >::complete(*it, true);
+          }
+          for(typename std::list< CallPtr >::iterator it = failed.begin();
+              it != failed.end(); it++)
+          {
+            ServiceCall< SrvType >::complete(*it, false);
+          }
+          done.clear();
+          failed.clear();
         }
+        else if(detached)
+        {
+          /*
+           * no service to wait on, calls issued meanwhile fail right away
+           */
+          boost::this_thread::sleep(
+              boost::posix_time::milliseconds(
+                  (long)NS_NaviCommon::HEARTBEAT_PERIOD));
+        }
+      }
+    }
+
+  public:
+    /**
+     * \brief Time in milliseconds a call waits for the server before it
+     * gives up, SharedEvent::INFINITE_WAIT to wait for ever
+     */
+    void setTimeout(unsigned long milliseconds)
+    {
+      timeout = milliseconds;
+    }
+
+    bool call(SrvType& srv)
+    {
+      return call(srv, timeout);
+    }
+
+    /**
+     * \brief Call the service, waiting at most call_timeout milliseconds
+     */
+    bool call(SrvType& srv, unsigned long call_timeout)
+    {
+      return call(srv, call_timeout, NULL);
+    }
+
+    bool callCached(SrvType& srv, uint64_t& version)
+    {
+      return call(srv, timeout, &version);
+    }
+
+    /**
+     * \brief Call a caching server, see Server::setCacheVersion().
+     *
+     * version is the version of the reply already held in srv, 0 for none.
+     * srv is only replaced when the server has a different one, version is
+     * updated to it.
+     */
+    bool callCached(SrvType& srv, uint64_t& version,
+                    unsigned long call_timeout)
+    {
+      return call(srv, call_timeout, &version);
+    }
+
+  private:
+    bool call(SrvType& srv, unsigned long call_timeout, uint64_t* version)
+    {
+      boost::shared_lock< NS_NaviCommon::RemapLock > use(
+          attach_lock, boost::defer_lock);
+      if(!attached(use))
+      {
+        return false;
       }
 
-      scoped_lock< interprocess_mutex > lock(operation->lock);
+      scoped_lock< NS_NaviCommon::SharedMutex > lock(operation->lock);
 
-      operation->status = SERVICE_PROCESSING;
-      operation->req_cond.notify_all();
+      if(!serverAlive(operation))
+      {
+        return false;
+      }
+
+      uint64_t deadline = NS_NaviCommon::SharedEvent::deadline(call_timeout);
 
-      int try_times = 10;
-      bool timeout = false;
-      while(operation->status == SERVICE_PROCESSING)
+      int index;
+      while((index = request(lock, srv, version)) == NO_FREE_SLOT)
       {
-        operation->req_cond.timed_wait(
-            lock,
-            (boost::get_system_time() + boost::posix_time::microseconds(100)));
-        if(try_times-- < 0)
+        if(!operation->rep_event.wait(lock, waitDeadline(deadline))
+            && freeSlot() < 0
+            && (expired(deadline, NS_NaviCommon::SharedEvent::now())
+                || !serverAlive(operation)))
         {
-          timeout = true;
-          break;
+          NS_NaviCommon::recordTimeout(operation->statistics);
+          return false;
         }
       }
 
-      if(timeout)
+      if(index == REQUEST_FAILED)
       {
         return false;
       }
 
-      std::string srv_shm_name = service_name + "_SRV";
+      while(operation->slots[index].status != SERVICE_SLOT_REPLIED)
+      {
+        if(!operation->rep_event.wait(lock, waitDeadline(deadline))
+            && operation->slots[index].status != SERVICE_SLOT_REPLIED
+            && (expired(deadline, NS_NaviCommon::SharedEvent::now())
+                || !serverAlive(operation)))
+        {
+          giveUp(index);
+          return false;
+        }
+      }
+
+      return reply(lock, index, srv, version);
+    }
 
-      shared_memory_object srv_shm(open_only, srv_shm_name.c_str(), read_write);
+  public:
+    CallPtr callAsync(const SrvType& srv,
+                      const CompletionCallback& callback = CompletionCallback(),
+                      NS_NaviCommon::CallbackQueueInterface* queue = NULL)
+    {
+      return callAsync(srv, timeout, callback, queue);
+    }
 
-      srv_region = mapped_region(srv_shm, read_write);
+    /**
+     * \brief Issue a call without waiting for it.
+     *
+     * The returned handle tells when the call is done; callback is then
+     * invoked with it, on queue when one is given, otherwise in the thread
+     * of the client completing the calls. The call fails once call_timeout
+     * milliseconds passed without a reply. Completions queued for a client
+     * share its owner id, so they run one at a time and those not run yet
+     * are dropped when the client is destroyed.
+     */
+    CallPtr callAsync(const SrvType& srv, unsigned long call_timeout,
+                      const CompletionCallback& callback = CompletionCallback(),
+                      NS_NaviCommon::CallbackQueueInterface* queue = NULL)
+    {
+      CallPtr call(
+          new ServiceCall< SrvType >(
+              srv, NS_NaviCommon::SharedEvent::deadline(call_timeout)));
+      call->callback = callback;
+      call->callback_queue = queue;
+      call->removal_id = (unsigned long)this;
+
+      if(queue)
+      {
+        boost::mutex::scoped_lock lock(calls_lock);
+        completion_queues.insert(queue);
+      }
 
-      void* region_addr = srv_region.get_address();
+      boost::shared_lock< NS_NaviCommon::RemapLock > use(
+          attach_lock, boost::defer_lock);
+      if(!attached(use))
+      {
+        use.unlock();
+        ServiceCall< SrvType >::complete(call, false);
+        return call;
+      }
 
-      NS_NaviCommon::IStream stream((unsigned char*)region_addr,
-                                    operation->buf_len);
+      /*
+       * the request goes out right away when a slot is free, otherwise the
+       * completion thread issues it once one is
+       */
+      {
+        scoped_lock< NS_NaviCommon::SharedMutex > lock(operation->lock);
+        int index = request(lock, call->srv);
+        if(index == REQUEST_FAILED)
+        {
+          lock.unlock();
+          use.unlock();
+          ServiceCall< SrvType >::complete(call, false);
+          return call;
+        }
+        call->slot = index;
+      }
 
-      NS_NaviCommon::deserialize(stream, srv);
+      {
+        boost::mutex::scoped_lock lock(calls_lock);
+        async_calls.push_back(call);
+        if(!completion_active)
+        {
+          completion_active = true;
+          completion_thread = boost::thread(
+              boost::bind(&Client::completer, this, operation));
+        }
+      }
+      operation->rep_event.notify();
 
-      return true;
+      return call;
     }
   };
 
@@ -0,0 +1,278 @@
+/*
+ * MapSync.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: root
+ */
+
+#ifndef _SERVICE_MAP_SYNC_H_
+#define _SERVICE_MAP_SYNC_H_
+
+#include <deque>
+#include <string.h>
+#include <boost/thread/mutex.hpp>
+#include "ServiceType/ServiceMapUpdate.h"
+
+namespace NS_Service
+{
+
+  enum
+  {
+    MAP_SYNC_HISTORY = 64,
+  };
+
+  /**
+   * \brief Write the cells of update into map.
+   * \return false if the patch does not lie within the map
+   */
+  template< class MapAllocator, class UpdateAllocator >
+  inline bool applyMapUpdate(
+      NS_DataType::OccupancyGrid_< MapAllocator >& map,
+      const NS_DataType::OccupancyGridUpdate_< UpdateAllocator >& update)
+  {
+    int map_width = map.info.width;
+    int map_height = map.info.height;
+
+    if(update.x < 0 || update.y < 0 || update.width < 0 || update.height < 0
+        || update.x + update.width > map_width
+        || update.y + update.height > map_height
+        || map.data.size() != (size_t)map_width * map_height
+        || update.data.size() != (size_t)update.width * update.height)
+    {
+      return false;
+    }
+
+    for(int row = 0; row < update.height; row++)
+    {
+      memcpy(&map.data[(size_t)(update.y + row) * map_width + update.x],
+             &update.data[(size_t)row * update.width], update.width);
+    }
+
+    return true;
+  }
+
+  /**
+   * \brief Copy the cells of a rectangle of map into update.
+   */
+  template< class MapAllocator, class UpdateAllocator >
+  inline void extractMapUpdate(
+      const NS_DataType::OccupancyGrid_< MapAllocator >& map, int x, int y,
+      int width, int height,
+      NS_DataType::OccupancyGridUpdate_< UpdateAllocator >& update)
+  {
+    int map_width = map.info.width;
+
+    update.header = map.header;
+    update.x = x;
+    update.y = y;
+    update.width = width;
+    update.height = height;
+    update.data.resize((size_t)width * height);
+
+    for(int row = 0; row < height; row++)
+    {
+      memcpy(&update.data[(size_t)row * width],
+             &map.data[(size_t)(y + row) * map_width + x], width);
+    }
+  }
+
+  /**
+   * \brief Bring a local copy of the map up to the version of a
+   * ServiceMapUpdate reply.
+   *
+   * version is the version of map, 0 for none; it is updated on success.
+   * On failure the caller should request again with version 0.
+   */
+  template< class ContainerAllocator >
+  inline bool applyMapSync(
+      const NS_ServiceType::ServiceMapUpdate_< ContainerAllocator >& srv,
+      NS_DataType::OccupancyGrid_< ContainerAllocator >& map,
+      uint64_t& version)
+  {
+    if(!srv.result)
+    {
+      return false;
+    }
+
+    if(srv.full)
+    {
+      map = srv.map;
+    }
+    else
+    {
+      for(size_t i = 0; i < srv.updates.size(); i++)
+      {
+        if(!applyMapUpdate(map, srv.updates[i]))
+        {
+          version = 0;
+          return false;
+        }
+      }
+    }
+
+    version = srv.version;
+
+    return true;
+  }
+
+  /**
+   * \brief Producer side of an incrementally synchronized map.
+   *
+   * Every update() is a new version and its rectangle is remembered, up to
+   * history versions back. serve(), the entry of a
+   * Server<ServiceMapUpdate>, answers a caller holding a remembered
+   * version with the patches since, cut from the current map, and with
+   * the whole map when its version is unknown or the patches would cover
+   * more than full_ratio of it. The same patches can be published through
+   * a Publisher<OccupancyGridUpdate> for consumers that follow every
+   * change.
+   */
+  class MapSync
+  {
+  public:
+    MapSync(size_t history = MAP_SYNC_HISTORY, double full_ratio = 0.25)
+        : version_(0), base_version_(0), history_(history),
+          full_ratio_(full_ratio)
+    {
+    }
+
+    /**
+     * \brief Replace the whole map, every caller gets it in full again
+     */
+    void setMap(const NS_DataType::OccupancyGrid& map)
+    {
+      boost::mutex::scoped_lock lock(lock_);
+      map_ = map;
+      version_++;
+      base_version_ = version_;
+      dirty_.clear();
+    }
+
+    /**
+     * \brief Apply a patch to the map.
+     * \return false if there is no map yet or the patch does not fit in
+     */
+    bool update(const NS_DataType::OccupancyGridUpdate& patch)
+    {
+      boost::mutex::scoped_lock lock(lock_);
+
+      if(!version_ || !applyMapUpdate(map_, patch))
+      {
+        return false;
+      }
+
+      if(patch.header.stamp > map_.header.stamp)
+      {
+        map_.header.stamp = patch.header.stamp;
+      }
+
+      DirtyRect rect;
+      rect.x = patch.x;
+      rect.y = patch.y;
+      rect.width = patch.width;
+      rect.height = patch.height;
+      dirty_.push_back(rect);
+      version_++;
+
+      while(dirty_.size() > history_)
+      {
+        dirty_.pop_front();
+      }
+
+      return true;
+    }
+
+    uint64_t getVersion()
+    {
+      boost::mutex::scoped_lock lock(lock_);
+      return version_;
+    }
+
+    void getMap(NS_DataType::OccupancyGrid& map)
+    {
+      boost::mutex::scoped_lock lock(lock_);
+      map = map_;
+    }
+
+    void serve(NS_ServiceType::ServiceMapUpdate& srv)
+    {
+      boost::mutex::scoped_lock lock(lock_);
+
+      uint64_t requested = srv.version;
+
+      srv.result = version_ != 0;
+      srv.version = version_;
+      srv.full = false;
+      srv.map = NS_DataType::OccupancyGrid();
+      srv.updates.clear();
+
+      if(!version_ || requested == version_)
+      {
+        return;
+      }
+
+      /*
+       * dirty_ holds the rectangles of versions
+       * (version_ - dirty_.size(), version_]
+       */
+      uint64_t oldest = version_ - dirty_.size();
+      if(requested < base_version_ || requested < oldest
+          || requested > version_)
+      {
+        srv.full = true;
+        srv.map = map_;
+        return;
+      }
+
+      size_t first = requested - oldest;
+      size_t area = 0;
+      for(size_t i = first; i < dirty_.size(); i++)
+      {
+        area += (size_t)dirty_[i].width * dirty_[i].height;
+      }
+
+      if(area > full_ratio_ * map_.data.size())
+      {
+        srv.full = true;
+        srv.map = map_;
+        return;
+      }
+
+      srv.updates.resize(dirty_.size() - first);
+      for(size_t i = first; i < dirty_.size(); i++)
+      {
+        const DirtyRect& rect = dirty_[i];
+        extractMapUpdate(map_, rect.x, rect.y, rect.width, rect.height,
+                         srv.updates[i - first]);
+      }
+    }
+
+  private:
+    typedef struct
+    {
+      int x;
+      int y;
+      int width;
+      int height;
+    } DirtyRect;
+
+    boost::mutex lock_;
+
+    NS_DataType::OccupancyGrid map_;
+
+    uint64_t version_;
+
+    /*
+     * version of the last setMap(), older versions need the whole map
+     */
+    uint64_t base_version_;
+
+    std::deque< DirtyRect > dirty_;
+
+    size_t history_;
+    double full_ratio_;
+  };
+
+}
+
+#endif /* _SERVICE_MAP_SYNC_H_ */
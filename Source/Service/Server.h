@@ -11,8 +11,14 @@
 #include <boost/interprocess/shared_memory_object.hpp>
 #include <boost/interprocess/mapped_region.hpp>
 #include <boost/interprocess/sync/scoped_lock.hpp>
+#include <string.h>
+#include <vector>
 #include "Service.h"
+#include "../Common/SharedSegment.h"
+#include "../Callbacks/CallbackQueueInterface.h"
+#include "../Callbacks/ReceiveMultiplexer.h"
 #include "../Console/Console.h"
+#include "../Serialization/Serialization.h"
 
 namespace NS_Service
 {
@@ -20,25 +26,132 @@ namespace NS_Service
   using namespace boost::interprocess;
 
   template< typename SrvType >
-  class Server
+  class Server: public NS_NaviCommon::MultiplexedChannel
   {
     typedef boost::function< void(SrvType&) > ServiceEntryType;
 
   public:
-    Server(std::string name, ServiceEntryType entry)
+    /**
+     * \param workers number of threads serving requests; the entry must be
+     * reentrant when it is more than one
+     * \param queue serve the requests through this callback queue instead of
+     * worker threads, workers is ignored then: the ReceiveMultiplexer of the
+     * process watches the service and the entry runs on the threads spinning
+     * the queue. Each request slot has its own removal id, so the requests
+     * are served in parallel when several threads spin the queue; the entry
+     * must be reentrant then
+     */
+    Server(std::string name, ServiceEntryType entry, unsigned int workers = 1,
+           NS_NaviCommon::CallbackQueueInterface* queue = NULL)
     {
       service_name = name;
       service_entry = entry;
+      operation = NULL;
+      active = false;
+      callback_queue = queue;
+      doorbell = 0;
+      memset(queued, 0, sizeof(queued));
+      last_reclaim = 0;
+      cache_version = 0;
+      cached_version = 0;
+
+      for(uint32_t i = 0; i < SERVICE_SLOTS; i++)
+      {
+        srv_segments[i].setName(serviceArenaName(service_name, i));
+      }
 
-      makeSrv();
+      makeSrv(workers ? workers : 1);
+    }
+
+    /**
+     * \brief Answer calls from a cache while version stays the same.
+     *
+     * Only for services whose reply does not depend on the request. The
+     * first call of a version runs the entry, later ones get its serialized
+     * reply without running it, and Client::callCached() callers already
+     * holding the version get no reply at all. Set a new version, e.g. the
+     * stamp of the data served, whenever the reply would change; 0 turns
+     * the cache off.
+     */
+    void setCacheVersion(uint64_t version)
+    {
+      boost::mutex::scoped_lock lock(cache_lock);
+      cache_version = version;
+    }
+
+    /**
+     * \brief Enable the cache if needed and drop the cached reply
+     */
+    void invalidateCache()
+    {
+      boost::mutex::scoped_lock lock(cache_lock);
+      cache_version++;
+      if(cache_version == 0)
+      {
+        cache_version++;
+      }
     }
 
     virtual ~Server()
     {
       if(active)
       {
-        active = false;
-        service_thread.join();
+        {
+          scoped_lock< NS_NaviCommon::SharedMutex > lock(operation->lock);
+          active = false;
+          operation->server_pid = 0;
+          operation->server_doorbell = 0;
+        }
+        operation->rep_event.notify();
+
+        if(doorbell)
+        {
+          NS_NaviCommon::ReceiveMultiplexer::instance().remove(this);
+          for(uint32_t i = 0; i < SERVICE_SLOTS; i++)
+          {
+            callback_queue->removeByID(slotID(i));
+          }
+        }
+        else
+        {
+          operation->req_event.notify();
+          service_threads.join_all();
+        }
+      }
+    }
+
+    /*
+     * called by the multiplexer, queues one serve callback per pending
+     * request, oldest first
+     */
+    virtual void poll()
+    {
+      scoped_lock< NS_NaviCommon::SharedMutex > lock(operation->lock);
+
+      uint64_t current = NS_NaviCommon::SharedEvent::now();
+      operation->server_heartbeat = current;
+
+      if(operation->lock.recovered()
+          || current - last_reclaim
+              >= NS_NaviCommon::HEARTBEAT_PERIOD * 1000000ULL)
+      {
+        reclaimSlots(operation);
+        last_reclaim = current;
+      }
+
+      if(!active)
+      {
+        return;
+      }
+
+      int index;
+      while((index = pendingSlot(queued)) >= 0)
+      {
+        queued[index] = true;
+        callback_queue->addCallback(
+            NS_NaviCommon::CallbackInterfacePtr(
+                new ServeCallback(this, index)),
+            slotID(index));
       }
     }
 
@@ -49,70 +162,136 @@ namespace NS_Service
 
     boost::mutex proc_lock;
 
-    boost::thread service_thread;
+    boost::thread_group service_threads;
 
     ServiceOperation* operation;
 
     mapped_region oper_region;
-    mapped_region srv_region;
+
+    /*
+     * a slot is served by one worker at a time, which uses its mapping
+     */
+    NS_NaviCommon::SharedSegment srv_segments[SERVICE_SLOTS];
 
     bool active;
 
+    /*
+     * with a doorbell the multiplexer polls the service, queued tells the
+     * slots which have a serve callback in the queue
+     */
+    NS_NaviCommon::CallbackQueueInterface* callback_queue;
+    uint32_t doorbell;
+    bool queued[SERVICE_SLOTS];
+    uint64_t last_reclaim;
+
+    /*
+     * serialized reply of cached_version, shared by the workers
+     */
+    boost::mutex cache_lock;
+    uint64_t cache_version;
+    uint64_t cached_version;
+    boost::shared_ptr< const std::vector< uint8_t > > cached_reply;
+
   private:
 
-    void makeSrv()
+    void makeSrv(unsigned int workers)
     {
       //shared_memory_object::remove (service_name.c_str ());
 
       try
       {
-        shared_memory_object oper_shm(open_or_create, service_name.c_str(),
-                                      read_write);
-
-        oper_shm.truncate(sizeof(ServiceOperation));
-
-        oper_region = mapped_region(oper_shm, read_write);
-
-        void* region_addr = oper_region.get_address();
-
-        operation = new (region_addr) ServiceOperation;
+        operation = attachService(service_name, oper_region, true);
       }
       catch(interprocess_exception& exception)
+      {
+        operation = NULL;
+      }
+
+      if(!operation)
       {
         printf("create service fail!\n");
         return;
       }
 
-      active = true;
-      service_thread = boost::thread(boost::bind(&Server::processor, this));
-    }
-
-    void*
-    getSrv()
-    {
-      std::string srv_shm_name = service_name + "_SRV";
+      if(callback_queue)
+      {
+        doorbell = NS_NaviCommon::ReceiveMultiplexer::instance().getDoorbell();
+      }
 
-      shared_memory_object srv_shm(open_only, srv_shm_name.c_str(), read_write);
+      {
+        scoped_lock< NS_NaviCommon::SharedMutex > lock(operation->lock);
+
+        operation->lock.recovered();
+
+        /*
+         * requests a previous server died on are served again, slots of
+         * dead clients are freed
+         */
+        reclaimSlots(operation);
+
+        /*
+         * a server still running decides the type of the service
+         */
+        NS_NaviCommon::TypeSignature signature =
+            NS_NaviCommon::typeSignature< SrvType >();
+        if(!NS_NaviCommon::bindType(operation->type, signature,
+                                    !serverAlive(operation)))
+        {
+          printf("service %s serves %s, can not serve %s!\n",
+                 service_name.c_str(), operation->type.name, signature.name);
+          return;
+        }
 
-      srv_region = mapped_region(srv_shm, read_write);
+        operation->server_pid = NS_NaviCommon::currentProcess();
+        operation->server_heartbeat = NS_NaviCommon::SharedEvent::now();
+        operation->server_doorbell = doorbell;
+      }
 
-      void* region_addr = srv_region.get_address();
+      active = true;
+      if(doorbell)
+      {
+        NS_NaviCommon::ReceiveMultiplexer::instance().add(this);
+        return;
+      }
 
-      return region_addr;
+      for(unsigned int i = 0; i < workers; i++)
+      {
+        service_threads.create_thread(boost::bind(&Server::processor, this));
+      }
     }
 
-    void resize(size_t size)
+    /*
+     * the version may have moved on while the entry ran
+     */
+    void storeReply(uint64_t version, const uint8_t* data, size_t length)
     {
-      std::string srv_shm_name = service_name + "_SRV";
+      boost::shared_ptr< const std::vector< uint8_t > > reply(
+          new std::vector< uint8_t >(data, data + length));
 
-      shared_memory_object::remove(srv_shm_name.c_str());
-
-      shared_memory_object srv_shm(create_only, srv_shm_name.c_str(),
-                                   read_write);
-
-      srv_shm.truncate(size);
+      boost::mutex::scoped_lock lock(cache_lock);
+      if(cache_version == version)
+      {
+        cached_version = version;
+        cached_reply = reply;
+      }
+    }
 
-      operation->buf_len = size;
+    /*
+     * oldest pending request, -1 if none; called with the lock held
+     */
+    int pendingSlot(const bool* skip = NULL)
+    {
+      int pending = -1;
+      for(uint32_t i = 0; i < SERVICE_SLOTS; i++)
+      {
+        const ServiceSlot& slot = operation->slots[i];
+        if(slot.status == SERVICE_SLOT_REQUESTED && !(skip && skip[i])
+            && (pending < 0 || slot.id < operation->slots[pending].id))
+        {
+          pending = i;
+        }
+      }
+      return pending;
     }
 
     void processor()
@@ -121,36 +300,191 @@ namespace NS_Service
       {
         if(operation)
         {
-          scoped_lock< interprocess_mutex > lock(operation->lock);
-
-          while(operation->status == SERVICE_IDLE)
+          scoped_lock< NS_NaviCommon::SharedMutex > lock(operation->lock);
+
+          /*
+           * wake up at least every heartbeat period to show the server is
+           * still there and to free the slots of clients that died
+           */
+          int index;
+          while(active && (index = pendingSlot()) < 0)
           {
-            operation->req_cond.timed_wait(
+            operation->server_heartbeat = NS_NaviCommon::SharedEvent::now();
+            if(!operation->req_event.wait(
                 lock,
-                (boost::get_system_time() + boost::posix_time::seconds(1)));
+                NS_NaviCommon::SharedEvent::deadline(
+                    NS_NaviCommon::HEARTBEAT_PERIOD)))
+            {
+              reclaimSlots(operation);
+            }
           }
 
-          if(service_entry)
+          if(!active)
           {
-            unsigned char* addr;
+            break;
+          }
 
-            SrvType srv;
+          if(operation->lock.recovered())
+          {
+            reclaimSlots(operation);
+          }
+          operation->server_heartbeat = NS_NaviCommon::SharedEvent::now();
 
-            service_entry(srv);
+          serve(lock, index);
+        }
+      }
+    }
 
-            operation->buf_len = NS_NaviCommon::serializationLength(srv);
+    /*
+     * answer the request in slot index, called with the lock held and
+     * returns with it held
+     */
+    void serve(scoped_lock< NS_NaviCommon::SharedMutex >& lock, int index)
+    {
+      ServiceSlot& slot = operation->slots[index];
+      NS_NaviCommon::SharedSegment& srv_segment = srv_segments[index];
+      slot.status = SERVICE_SLOT_PROCESSING;
+
+      /*
+       * the slot belongs to this worker until it is answered, so the
+       * request, the entry and the reply all run unlocked
+       */
+      lock.unlock();
+
+      uint64_t version;
+      boost::shared_ptr< const std::vector< uint8_t > > cached;
+      {
+        boost::mutex::scoped_lock cache(cache_lock);
+        version = cache_version;
+        if(version && cached_version == version)
+        {
+          cached = cached_reply;
+        }
+      }
 
-            resize(operation->buf_len);
-            addr = (unsigned char*)getSrv();
+      slot.buf_len = 0;
+      slot.modified = 1;
 
-            NS_NaviCommon::OStream stream(addr, operation->buf_len);
-            NS_NaviCommon::serialize(stream, srv);
+      if(version && slot.version == version)
+      {
+        slot.modified = 0;
+      }
+      else if(cached)
+      {
+        if(srv_segment.reserve(cached->size(), slot.capacity,
+                               slot.generation))
+        {
+          memcpy(srv_segment.getAddress(), &(*cached)[0], cached->size());
+          slot.buf_len = cached->size();
+        }
+      }
+      else
+      {
+        SrvType srv;
+
+        if(slot.req_len
+            && srv_segment.sync(slot.capacity, slot.generation))
+        {
+          NS_NaviCommon::IStream request(srv_segment.getAddress(),
+                                         slot.req_len);
+          NS_NaviCommon::deserialize(request, srv);
+        }
+
+        if(service_entry)
+        {
+          service_entry(srv);
+        }
+
+        /*
+         * the reply overwrites the request in place, the arena only
+         * grows when it does not fit
+         */
+        size_t length;
+        if(writeArena(srv_segment, slot, srv, length))
+        {
+          slot.buf_len = length;
 
-            operation->status = SERVICE_IDLE;
-            operation->rep_cond.notify_all();
+          if(version)
+          {
+            storeReply(version, srv_segment.getAddress(), length);
           }
         }
       }
+
+      slot.version = version;
+
+      NS_NaviCommon::recordTransfer(operation->statistics, slot.buf_len);
+      NS_NaviCommon::recordDelivery(operation->statistics, slot.stamp);
+
+      lock.lock();
+
+      if(slot.status == SERVICE_SLOT_ABANDONED)
+      {
+        slot.status = SERVICE_SLOT_FREE;
+      }
+      else
+      {
+        slot.status = SERVICE_SLOT_REPLIED;
+      }
+      operation->rep_event.notify();
+    }
+
+    class ServeCallback: public NS_NaviCommon::CallbackInterface
+    {
+    public:
+      ServeCallback(Server* server, int index)
+          : server_(server), index_(index)
+      {
+      }
+
+      CallResult call()
+      {
+        server_->serveQueued(index_);
+        return Success;
+      }
+
+    private:
+      Server* server_;
+      int index_;
+    };
+
+    /*
+     * removal id of the serve callbacks of slot index, unique in the
+     * process as it is an address
+     */
+    unsigned long slotID(uint32_t index)
+    {
+      return (unsigned long)&srv_segments[index];
+    }
+
+    /*
+     * a queued serve, run by a spinner thread; the request of its slot may
+     * have been withdrawn meanwhile
+     */
+    void serveQueued(int index)
+    {
+      scoped_lock< NS_NaviCommon::SharedMutex > lock(operation->lock);
+
+      queued[index] = false;
+
+      if(!active)
+      {
+        return;
+      }
+
+      if(operation->lock.recovered())
+      {
+        reclaimSlots(operation);
+      }
+
+      if(operation->slots[index].status != SERVICE_SLOT_REQUESTED)
+      {
+        return;
+      }
+
+      operation->server_heartbeat = NS_NaviCommon::SharedEvent::now();
+
+      serve(lock, index);
     }
 
   };
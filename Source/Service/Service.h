@@ -9,31 +9,358 @@
 #define _SERVICE_SERVICE_H_
 
 #include <map>
+#include <string>
+#include <stdio.h>
 #include <boost/thread/thread.hpp>
 #include <boost/thread/mutex.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/function.hpp>
-#include <boost/interprocess/sync/interprocess_condition.hpp>
+#include <string.h>
+#include <unistd.h>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include "../Thread/Atomic.h"
+#include "../Thread/SharedEvent.h"
+#include "../Thread/SharedMutex.h"
+#include "../Common/Liveness.h"
+#include "../Common/Doorbell.h"
+#include "../Common/ChannelStatistics.h"
+#include "../Common/TypeSignature.h"
+#include "../Common/SharedSegment.h"
+#include "../Serialization/Serialization.h"
 #include "ServiceType/ServiceBase.h"
 
 namespace NS_Service
 {
+  /*
+   * life cycle of a request slot: a client claims a free slot, writes its
+   * request and marks it requested; a server worker takes it over
+   * (processing) and answers it (replied); the client reads the reply and
+   * frees the slot. A slot whose client gave up while it was processed is
+   * abandoned and freed by the worker
+   */
   typedef enum
   {
-    SERVICE_IDLE,
-    SERVICE_PROCESSING,
-  } ServiceStatus;
+    SERVICE_SLOT_FREE,
+    SERVICE_SLOT_CLAIMED,
+    SERVICE_SLOT_REQUESTED,
+    SERVICE_SLOT_PROCESSING,
+    SERVICE_SLOT_REPLIED,
+    SERVICE_SLOT_ABANDONED,
+  } ServiceSlotStatus;
+
+  enum
+  {
+    SERVICE_SLOTS = 8,
+  };
+
+  /*
+   * default time in milliseconds a call waits for the server, see
+   * Client::setTimeout()
+   */
+  const unsigned long SERVICE_DEFAULT_TIMEOUT = 1000;
+
+  /*
+   * set by the server once the control block is constructed
+   */
+  const uint32_t SERVICE_MAGIC = 0x53525643;
+
+  /*
+   * written by the watchdog before it removes an abandoned service, peers
+   * still mapping the block attach again
+   */
+  const uint32_t SERVICE_RETIRED = 0x53525644;
 
   typedef struct
   {
-    boost::interprocess::interprocess_mutex lock;
-    boost::interprocess::interprocess_condition req_cond;
-    boost::interprocess::interprocess_condition rep_cond;
-    ServiceStatus status;
+    ServiceSlotStatus status;
+
+    /*
+     * correlation id of the call owning the slot
+     */
+    uint64_t id;
+
+    /*
+     * capacity of the <name>_SRV<index> arena of the slot, the generation
+     * is bumped whenever it grows, see SharedSegment. The request is
+     * serialized at its start by the client (req_len bytes), the server
+     * overwrites it with the reply (buf_len bytes)
+     */
+    size_t capacity;
+    uint32_t generation;
 
+    size_t req_len;
     size_t buf_len;
+
+    /*
+     * version of the reply held by the client, 0 for none; on return the
+     * version of a caching server, see Server::setCacheVersion(), and
+     * modified is cleared when the client's version is still current and
+     * no reply was written
+     */
+    uint64_t version;
+    uint32_t modified;
+
+    /*
+     * SharedEvent::now() of the request
+     */
+    uint64_t stamp;
+
+    /*
+     * process of the client owning the slot
+     */
+    uint32_t client_pid;
+  } ServiceSlot;
+
+  typedef struct
+  {
+    uint32_t magic;
+
+    /*
+     * the lock only guards slot state changes, requests and replies are
+     * (de)serialized unlocked by the owner of the slot. req_event is
+     * notified when a request is issued, rep_event when a slot is
+     * answered or freed. The lock survives the death of its owner
+     */
+    NS_NaviCommon::SharedMutex lock;
+    NS_NaviCommon::SharedEvent req_event;
+    NS_NaviCommon::SharedEvent rep_event;
+
+    uint64_t next_id;
+    ServiceSlot slots[SERVICE_SLOTS];
+
+    /*
+     * process of the server, 0 once it stopped; heartbeat is the
+     * SharedEvent::now() its workers were last seen running, at least every
+     * HEARTBEAT_PERIOD. server_doorbell is the one of the
+     * ReceiveMultiplexer serving a server without threads, 0 for none
+     */
+    uint32_t server_pid;
+    uint64_t server_heartbeat;
+    uint32_t server_doorbell;
+
+    /*
+     * service type bound by the server, clients of another type are
+     * rejected
+     */
+    NS_NaviCommon::TypeSignature type;
+
+    NS_NaviCommon::ChannelStatistics statistics;
   } ServiceOperation;
 
+  /*
+   * wake the server when a request is pending, called with the lock held
+   */
+  inline void notifyServer(ServiceOperation* operation)
+  {
+    operation->req_event.notify();
+    NS_NaviCommon::ringDoorbell(operation->server_doorbell);
+  }
+
+  inline bool serverAlive(ServiceOperation* operation)
+  {
+    return NS_NaviCommon::processAlive(operation->server_pid);
+  }
+
+  /*
+   * free the slots of clients that died, and hand the requests a dead
+   * server was working on to the next one; called with the lock held
+   */
+  inline void reclaimSlots(ServiceOperation* operation)
+  {
+    bool server = serverAlive(operation);
+    bool freed = false;
+    bool requeued = false;
+
+    for(uint32_t i = 0; i < SERVICE_SLOTS; i++)
+    {
+      ServiceSlot& slot = operation->slots[i];
+
+      switch(slot.status)
+      {
+        case SERVICE_SLOT_CLAIMED:
+        case SERVICE_SLOT_REQUESTED:
+        case SERVICE_SLOT_REPLIED:
+          if(!NS_NaviCommon::processAlive(slot.client_pid))
+          {
+            slot.status = SERVICE_SLOT_FREE;
+            freed = true;
+          }
+          break;
+        case SERVICE_SLOT_PROCESSING:
+          if(!server)
+          {
+            slot.status = SERVICE_SLOT_REQUESTED;
+            requeued = true;
+          }
+          break;
+        case SERVICE_SLOT_ABANDONED:
+          if(!server)
+          {
+            slot.status = SERVICE_SLOT_FREE;
+            freed = true;
+          }
+          break;
+        default:
+          break;
+      }
+    }
+
+    if(freed)
+    {
+      operation->rep_event.notify();
+    }
+    if(requeued)
+    {
+      notifyServer(operation);
+    }
+  }
+
+  /*
+   * nobody alive uses the service any more: the server is gone and no slot
+   * is held by a living client; called with the lock held
+   */
+  inline bool serviceAbandoned(ServiceOperation* operation)
+  {
+    if(serverAlive(operation))
+    {
+      return false;
+    }
+
+    for(uint32_t i = 0; i < SERVICE_SLOTS; i++)
+    {
+      const ServiceSlot& slot = operation->slots[i];
+      if(slot.status != SERVICE_SLOT_FREE
+          && NS_NaviCommon::processAlive(slot.client_pid))
+      {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  /*
+   * map the control block of service name into region. With create the
+   * first process constructs the block, any other one waits until it is
+   * published by the magic number
+   */
+  inline ServiceOperation*
+  attachService(const std::string& name,
+                boost::interprocess::mapped_region& region, bool create)
+  {
+    using namespace boost::interprocess;
+
+    shared_memory_object oper_shm;
+    bool creator = false;
+
+    try
+    {
+      if(create)
+      {
+        oper_shm = shared_memory_object(create_only, name.c_str(),
+                                        read_write);
+        oper_shm.truncate(sizeof(ServiceOperation));
+        creator = true;
+      }
+    }
+    catch(interprocess_exception& exception)
+    {
+    }
+
+    if(!creator)
+    {
+      oper_shm = shared_memory_object(open_only, name.c_str(), read_write);
+
+      offset_t oper_size = 0;
+      for(int i = 0; i < 1000; i++)
+      {
+        if(oper_shm.get_size(oper_size) && oper_size != 0)
+        {
+          break;
+        }
+        usleep(1000);
+      }
+
+      if(oper_size != sizeof(ServiceOperation))
+      {
+        return NULL;
+      }
+    }
+
+    region = mapped_region(oper_shm, read_write);
+
+    void* region_addr = region.get_address();
+
+    if(creator)
+    {
+      ServiceOperation* oper = new (region_addr) ServiceOperation;
+      oper->next_id = 0;
+      memset(oper->slots, 0, sizeof(oper->slots));
+      oper->server_pid = 0;
+      oper->server_heartbeat = 0;
+      oper->server_doorbell = 0;
+      memset(&oper->type, 0, sizeof(oper->type));
+      memset(&oper->statistics, 0, sizeof(oper->statistics));
+      NS_NaviCommon::atomicStore(&oper->magic, SERVICE_MAGIC);
+      return oper;
+    }
+
+    ServiceOperation* oper = static_cast< ServiceOperation* >(region_addr);
+    for(int i = 0; i < 1000; i++)
+    {
+      if(NS_NaviCommon::atomicLoad(&oper->magic) == SERVICE_MAGIC)
+      {
+        return oper;
+      }
+      usleep(1000);
+    }
+
+    return NULL;
+  }
+
+  inline std::string serviceArenaName(const std::string& service_name,
+                                      uint32_t index)
+  {
+    char suffix[16];
+    snprintf(suffix, sizeof(suffix), "_SRV%u", index);
+    return service_name + suffix;
+  }
+
+  /*
+   * serialize srv into the arena of slot in a single pass, the arena only
+   * grows, and srv is copied over, when it does not fit. length is set to
+   * the bytes written; false if the arena can not be mapped or grown
+   */
+  template< typename SrvType >
+  inline bool writeArena(NS_NaviCommon::SharedSegment& segment,
+                         ServiceSlot& slot, const SrvType& srv,
+                         size_t& length)
+  {
+    if(!segment.reserve(1, slot.capacity, slot.generation))
+    {
+      return false;
+    }
+
+    NS_NaviCommon::GrowableOStream stream(segment.getAddress(),
+                                          segment.getCapacity());
+    NS_NaviCommon::serialize(stream, srv);
+
+    if(stream.spilled())
+    {
+      if(!segment.reserve(stream.size(), slot.capacity, slot.generation))
+      {
+        return false;
+      }
+
+      memcpy(segment.getAddress(), stream.data(), stream.size());
+    }
+
+    length = stream.size();
+
+    return true;
+  }
+
 } /* namespace NS_NaviCommon */
 
 #endif /* SERVICE_SERVICE_H_ */
@@ -0,0 +1,181 @@
+/*
+ * ServiceCall.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: root
+ */
+
+#ifndef _SERVICE_SERVICE_CALL_H_
+#define _SERVICE_SERVICE_CALL_H_
+
+#include <boost/shared_ptr.hpp>
+#include <boost/function.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include "Service.h"
+#include "../Callbacks/CallbackQueueInterface.h"
+
+namespace NS_Service
+{
+
+  template< typename SrvType >
+  class Client;
+
+  /**
+   * \brief Handle of a call issued by Client::callAsync().
+   *
+   * The srv passed to callAsync() is copied into the handle and replaced by
+   * the reply once the call succeeded; it must not be touched before
+   * isDone() returns true.
+   */
+  template< typename SrvType >
+  class ServiceCall
+  {
+  public:
+    typedef boost::shared_ptr< ServiceCall< SrvType > > Ptr;
+    typedef boost::function< void(const Ptr&) > CompletionCallback;
+
+    typedef enum
+    {
+      CALL_PENDING,
+      CALL_SUCCEEDED,
+      CALL_FAILED,
+    } CallState;
+
+    ServiceCall(const SrvType& request, uint64_t call_deadline)
+        : srv(request), state(CALL_PENDING), deadline(call_deadline),
+          slot(-1), callback_queue(NULL), removal_id(0)
+    {
+    }
+
+    bool isDone()
+    {
+      boost::mutex::scoped_lock lock(mutex);
+      return state != CALL_PENDING;
+    }
+
+    bool succeeded()
+    {
+      boost::mutex::scoped_lock lock(mutex);
+      return state == CALL_SUCCEEDED;
+    }
+
+    /**
+     * \brief Block until the call is done, at most timeout milliseconds.
+     * \return true if the call succeeded
+     */
+    bool wait(unsigned long timeout = NS_NaviCommon::SharedEvent::INFINITE_WAIT)
+    {
+      boost::mutex::scoped_lock lock(mutex);
+
+      if(timeout == NS_NaviCommon::SharedEvent::INFINITE_WAIT)
+      {
+        while(state == CALL_PENDING)
+        {
+          condition.wait(lock);
+        }
+      }
+      else
+      {
+        boost::system_time until = boost::get_system_time()
+            + boost::posix_time::milliseconds(timeout);
+        while(state == CALL_PENDING)
+        {
+          if(!condition.timed_wait(lock, until))
+          {
+            break;
+          }
+        }
+      }
+
+      return state == CALL_SUCCEEDED;
+    }
+
+    SrvType&
+    getSrv()
+    {
+      return srv;
+    }
+
+  private:
+    friend class Client< SrvType > ;
+
+    SrvType srv;
+
+    CallState state;
+
+    /*
+     * SharedEvent clock, 0 never expires
+     */
+    uint64_t deadline;
+
+    /*
+     * request slot while the call is in flight, -1 before it is issued
+     */
+    int slot;
+
+    CompletionCallback callback;
+    NS_NaviCommon::CallbackQueueInterface* callback_queue;
+
+    /*
+     * owner id of the completion on callback_queue, the issuing client's so
+     * that it can drop them all at once
+     */
+    unsigned long removal_id;
+
+    boost::mutex mutex;
+    boost::condition_variable condition;
+
+    class CompletionQueueCallback: public NS_NaviCommon::CallbackInterface
+    {
+    public:
+      CompletionQueueCallback(const Ptr& call)
+          : call_(call)
+      {
+      }
+
+      CallResult call()
+      {
+        call_->callback(call_);
+        return Success;
+      }
+
+    private:
+      Ptr call_;
+    };
+
+    /*
+     * the callback runs on the given queue, or right away in the thread
+     * completing the call when there is none
+     */
+    static void complete(const Ptr& call, bool success)
+    {
+      {
+        boost::mutex::scoped_lock lock(call->mutex);
+        call->state = success ? CALL_SUCCEEDED : CALL_FAILED;
+        call->slot = -1;
+      }
+      call->condition.notify_all();
+
+      if(!call->callback)
+      {
+        return;
+      }
+
+      if(call->callback_queue)
+      {
+        call->callback_queue->addCallback(
+            NS_NaviCommon::CallbackInterfacePtr(
+                new CompletionQueueCallback(call)),
+            call->removal_id);
+      }
+      else
+      {
+        call->callback(call);
+      }
+    }
+  };
+
+}
+
+#endif /* _SERVICE_SERVICE_CALL_H_ */
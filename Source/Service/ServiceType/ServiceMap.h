@@ -144,7 +144,9 @@ namespace NS_NaviCommon
     static const char*
     value()
     {
-      return "";
+      return "bool result\n\
+OccupancyGrid map\n\
+";
     }
 
     static const char*
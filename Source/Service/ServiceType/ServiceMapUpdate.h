@@ -0,0 +1,171 @@
+/*
+ * ServiceMapUpdate.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: root
+ */
+
+#ifndef _SERVICETYPE_SERVICEMAPUPDATE_H_
+#define _SERVICETYPE_SERVICEMAPUPDATE_H_
+
+#include "../../DataSet/DataType/OccupancyGrid.h"
+#include "../../DataSet/DataType/OccupancyGridUpdate.h"
+#include "ServiceBase.h"
+
+namespace NS_ServiceType
+{
+
+  /*
+   * request: version of the map held by the caller, 0 for none.
+   * reply: the current version, and either the whole map (full) or the
+   * patches to apply since the requested version, see MapSync
+   */
+  template< class ContainerAllocator >
+  struct ServiceMapUpdate_
+  {
+    typedef ServiceMapUpdate_< ContainerAllocator > Type;
+  public:
+    ServiceMapUpdate_()
+        : result(false), version(0), full(false), map(), updates()
+    {
+    }
+    ;
+
+    ServiceMapUpdate_(const ContainerAllocator& allocator)
+        : result(false), version(0), full(false), map(allocator),
+          updates(allocator)
+    {
+    }
+    ;
+
+    bool result;
+    uint64_t version;
+    bool full;
+    NS_DataType::OccupancyGrid_< ContainerAllocator > map;
+    typename NS_NaviCommon::ContainerVector<
+        NS_DataType::OccupancyGridUpdate_< ContainerAllocator >,
+        ContainerAllocator >::Type updates;
+
+    typedef boost::shared_ptr< ServiceMapUpdate_< ContainerAllocator > > Ptr;
+    typedef boost::shared_ptr< ServiceMapUpdate_< ContainerAllocator > const > ConstPtr;
+  };
+
+  typedef ServiceMapUpdate_< std::allocator< void > > ServiceMapUpdate;
+
+  typedef boost::shared_ptr< ServiceMapUpdate > ServiceMapUpdatePtr;
+  typedef boost::shared_ptr< ServiceMapUpdate const > ServiceMapUpdateConstPtr;
+
+}
+
+namespace NS_NaviCommon
+{
+  template< class ContainerAllocator >
+  struct IsFixedSize< NS_ServiceType::ServiceMapUpdate_< ContainerAllocator > > : FalseType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct IsFixedSize< NS_ServiceType::ServiceMapUpdate_< ContainerAllocator > const > : FalseType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct IsMessage< NS_ServiceType::ServiceMapUpdate_< ContainerAllocator > > : TrueType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct IsMessage< NS_ServiceType::ServiceMapUpdate_< ContainerAllocator > const > : TrueType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct HasHeader< NS_ServiceType::ServiceMapUpdate_< ContainerAllocator > > : FalseType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct HasHeader< NS_ServiceType::ServiceMapUpdate_< ContainerAllocator > const > : FalseType
+  {
+  };
+
+  template< class ContainerAllocator >
+  struct MD5Sum< NS_ServiceType::ServiceMapUpdate_< ContainerAllocator > >
+  {
+    static const char*
+    value()
+    {
+      return "";
+    }
+
+    static const char*
+    value(const NS_ServiceType::ServiceMapUpdate_< ContainerAllocator >&)
+    {
+      return value();
+    }
+    static const uint64_t static_value1 = 0;
+    static const uint64_t static_value2 = 0;
+  };
+
+  template< class ContainerAllocator >
+  struct DataType< NS_ServiceType::ServiceMapUpdate_< ContainerAllocator > >
+  {
+    static const char*
+    value()
+    {
+      return "ServiceMapUpdate";
+    }
+
+    static const char*
+    value(const NS_ServiceType::ServiceMapUpdate_< ContainerAllocator >&)
+    {
+      return value();
+    }
+  };
+
+  template< class ContainerAllocator >
+  struct Definition< NS_ServiceType::ServiceMapUpdate_< ContainerAllocator > >
+  {
+    static const char*
+    value()
+    {
+      return "bool result\n\
+uint64 version\n\
+bool full\n\
+OccupancyGrid map\n\
+OccupancyGridUpdate[] updates\n\
+";
+    }
+
+    static const char*
+    value(const NS_ServiceType::ServiceMapUpdate_< ContainerAllocator >&)
+    {
+      return value();
+    }
+  };
+
+} // namespace message_traits
+
+namespace NS_NaviCommon
+{
+
+  template< class ContainerAllocator >
+  struct Serializer< NS_ServiceType::ServiceMapUpdate_< ContainerAllocator > >
+  {
+    template< typename Stream, typename T >
+    inline static void allInOne(Stream& stream, T m)
+    {
+      stream.next(m.result);
+      stream.next(m.version);
+      stream.next(m.full);
+      stream.next(m.map);
+      stream.next(m.updates);
+    }
+
+    DECLARE_ALLINONE_SERIALIZER
+  }; // struct ServiceMapUpdate_
+
+}
+// namespace serialization
+
+#endif /* _SERVICETYPE_SERVICEMAPUPDATE_H_ */
@@ -145,7 +145,9 @@ namespace NS_NaviCommon
     static const char*
     value()
     {
-      return "";
+      return "bool result\n\
+Odometry odom\n\
+";
     }
 
     static const char*
@@ -118,7 +118,9 @@ namespace NS_NaviCommon
     static const char*
     value()
     {
-      return "";
+      return "bool result\n\
+string text\n\
+";
     }
 
     static const char*
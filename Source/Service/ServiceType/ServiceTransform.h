@@ -147,7 +147,9 @@ namespace NS_NaviCommon
     static const char*
     value()
     {
-      return "";
+      return "bool result\n\
+Transform transform\n\
+";
     }
 
     static const char*
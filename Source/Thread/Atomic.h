@@ -0,0 +1,66 @@
+/*
+ * Atomic.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: root
+ */
+
+#ifndef _THREAD_ATOMIC_H_
+#define _THREAD_ATOMIC_H_
+
+namespace NS_NaviCommon
+{
+
+  /*
+   * Thin wrappers over the gcc __atomic builtins. They work on plain
+   * integers, so they can be used on fields of control blocks which are
+   * placed in shared memory and accessed from several processes.
+   */
+
+  template< typename T >
+  inline T atomicLoad(const volatile T* ptr)
+  {
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+  }
+
+  template< typename T >
+  inline void atomicStore(volatile T* ptr, T value)
+  {
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+  }
+
+  template< typename T >
+  inline T atomicFetchAdd(volatile T* ptr, T value)
+  {
+    return __atomic_fetch_add(ptr, value, __ATOMIC_ACQ_REL);
+  }
+
+  template< typename T >
+  inline bool atomicCompareExchange(volatile T* ptr, T expected, T desired)
+  {
+    return __atomic_compare_exchange_n(ptr, &expected, desired, false,
+                                       __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+  }
+
+  inline void acquireFence()
+  {
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  }
+
+  inline void releaseFence()
+  {
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+  }
+
+  /*
+   * orders an earlier store before a later load, which acquire and release
+   * do not
+   */
+  inline void fullFence()
+  {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  }
+
+}
+
+#endif /* _THREAD_ATOMIC_H_ */
@@ -0,0 +1,85 @@
+/*
+ * RemapLock.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: root
+ */
+
+#ifndef _THREAD_REMAP_LOCK_H_
+#define _THREAD_REMAP_LOCK_H_
+
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/locks.hpp>
+
+namespace NS_NaviCommon
+{
+
+  /**
+   * \brief Guards a mapping of shared memory which may be replaced.
+   *
+   * Whoever touches the mapping holds the lock shared, through
+   * boost::shared_lock; whoever unmaps or replaces it holds it exclusively,
+   * through boost::unique_lock. Unlike boost::shared_mutex a waiting remap
+   * keeps new users out until it is done, so threads which take the lock
+   * over and over, like a completion loop, can not starve it.
+   */
+  class RemapLock
+  {
+  public:
+    RemapLock()
+        : users(0), remapping(false)
+    {
+    }
+
+    void lock_shared()
+    {
+      boost::mutex::scoped_lock lock(mutex);
+      while(remapping)
+      {
+        condition.wait(lock);
+      }
+      users++;
+    }
+
+    void unlock_shared()
+    {
+      boost::mutex::scoped_lock lock(mutex);
+      users--;
+      if(!users && remapping)
+      {
+        condition.notify_all();
+      }
+    }
+
+    void lock()
+    {
+      boost::mutex::scoped_lock lock(mutex);
+      while(remapping)
+      {
+        condition.wait(lock);
+      }
+      remapping = true;
+      while(users)
+      {
+        condition.wait(lock);
+      }
+    }
+
+    void unlock()
+    {
+      boost::mutex::scoped_lock lock(mutex);
+      remapping = false;
+      condition.notify_all();
+    }
+
+  private:
+    boost::mutex mutex;
+    boost::condition_variable condition;
+    unsigned int users;
+    bool remapping;
+  };
+
+}
+
+#endif /* _THREAD_REMAP_LOCK_H_ */
@@ -0,0 +1,146 @@
+/*
+ * SharedEvent.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: root
+ */
+
+#ifndef _THREAD_SHARED_EVENT_H_
+#define _THREAD_SHARED_EVENT_H_
+
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "Atomic.h"
+
+namespace NS_NaviCommon
+{
+
+  /**
+   * \brief Event counter on a Linux futex, to be placed in a control block
+   * in shared memory and used by several processes.
+   *
+   * notify() bumps the counter and wakes every waiter, a waiter sleeps in the
+   * kernel until the counter moves away from the value it has seen, so no
+   * cpu is spent while idle and a notification is never lost between
+   * checking a condition and going to sleep.
+   */
+  class SharedEvent
+  {
+  public:
+
+    enum
+    {
+      INFINITE_WAIT = 0xFFFFFFFF,
+    };
+
+    SharedEvent()
+        : sequence(0), waiters(0)
+    {
+    }
+
+    /**
+     * \brief Absolute deadline for the wait functions, timeout in
+     * milliseconds; INFINITE_WAIT gives 0, which never expires
+     */
+    static uint64_t deadline(unsigned long timeout)
+    {
+      if(timeout == INFINITE_WAIT)
+      {
+        return 0;
+      }
+
+      return now() + (uint64_t)timeout * 1000000ULL;
+    }
+
+    uint32_t snapshot() const
+    {
+      return atomicLoad(&sequence);
+    }
+
+    void notify()
+    {
+      atomicFetchAdd(&sequence, (uint32_t)1);
+      fullFence();
+      if(atomicLoad(&waiters))
+      {
+        syscall(SYS_futex, &sequence, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+      }
+    }
+
+    /**
+     * \brief Sleep until the counter differs from seen.
+     * \return false if the deadline passed first
+     */
+    bool wait(uint32_t seen, uint64_t until)
+    {
+      bool notified = true;
+
+      atomicFetchAdd(&waiters, (uint32_t)1);
+      fullFence();
+
+      while(atomicLoad(&sequence) == seen)
+      {
+        struct timespec remain;
+        struct timespec* timeout = NULL;
+
+        if(until)
+        {
+          uint64_t current = now();
+          if(current >= until)
+          {
+            notified = false;
+            break;
+          }
+          remain.tv_sec = (until - current) / 1000000000ULL;
+          remain.tv_nsec = (until - current) % 1000000000ULL;
+          timeout = &remain;
+        }
+
+        syscall(SYS_futex, &sequence, FUTEX_WAIT, seen, timeout, NULL, 0);
+      }
+
+      atomicFetchAdd(&waiters, (uint32_t)-1);
+
+      return notified;
+    }
+
+    /**
+     * \brief Release lock, sleep until notified and take it again, as a
+     * condition variable does.
+     * \return false if the deadline passed first
+     */
+    template< typename Lock >
+    bool wait(Lock& lock, uint64_t until)
+    {
+      uint32_t seen = snapshot();
+
+      lock.unlock();
+      bool notified = wait(seen, until);
+      lock.lock();
+
+      return notified;
+    }
+
+    /**
+     * \brief Monotonic clock in nanoseconds, the same for every process
+     */
+    static uint64_t now()
+    {
+      struct timespec ts;
+      clock_gettime(CLOCK_MONOTONIC, &ts);
+      return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+    }
+
+  private:
+    uint32_t sequence;
+    uint32_t waiters;
+  };
+
+}
+
+#endif /* _THREAD_SHARED_EVENT_H_ */
@@ -0,0 +1,123 @@
+/*
+ * SharedMutex.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: root
+ */
+
+#ifndef _THREAD_SHARED_MUTEX_H_
+#define _THREAD_SHARED_MUTEX_H_
+
+#include <errno.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <boost/interprocess/exceptions.hpp>
+
+namespace NS_NaviCommon
+{
+
+  /**
+   * \brief Process shared robust mutex, to be placed in a control block in
+   * shared memory and used through boost::interprocess::scoped_lock.
+   *
+   * When its owner dies holding it, the next locker gets it instead of
+   * hanging for ever. The state it guards may then be half updated, so the
+   * code taking it must cope with that, see recovered().
+   */
+  class SharedMutex
+  {
+  public:
+    SharedMutex()
+        : owner_died(0)
+    {
+      init(false);
+    }
+
+    void lock()
+    {
+      int result = pthread_mutex_lock(&mutex);
+      if(result == EOWNERDEAD)
+      {
+        recover();
+      }
+      else if(result != 0)
+      {
+        throw boost::interprocess::lock_exception();
+      }
+    }
+
+    bool try_lock()
+    {
+      int result = pthread_mutex_trylock(&mutex);
+      if(result == EOWNERDEAD)
+      {
+        recover();
+        return true;
+      }
+
+      return result == 0;
+    }
+
+    void unlock()
+    {
+      pthread_mutex_unlock(&mutex);
+    }
+
+    /**
+     * \brief Whether the mutex was taken over from a dead owner since the
+     * last call, to be asked with the mutex held
+     */
+    bool recovered()
+    {
+      bool died = owner_died != 0;
+      owner_died = 0;
+      return died;
+    }
+
+  protected:
+    explicit SharedMutex(bool recursive)
+        : owner_died(0)
+    {
+      init(recursive);
+    }
+
+  private:
+    pthread_mutex_t mutex;
+    uint32_t owner_died;
+
+    void init(bool recursive)
+    {
+      pthread_mutexattr_t attr;
+      pthread_mutexattr_init(&attr);
+      pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+      pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+      if(recursive)
+      {
+        pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+      }
+      pthread_mutex_init(&mutex, &attr);
+      pthread_mutexattr_destroy(&attr);
+    }
+
+    void recover()
+    {
+      pthread_mutex_consistent(&mutex);
+      owner_died = 1;
+    }
+  };
+
+  /**
+   * \brief SharedMutex which the thread holding it may lock again
+   */
+  class SharedRecursiveMutex: public SharedMutex
+  {
+  public:
+    SharedRecursiveMutex()
+        : SharedMutex(true)
+    {
+    }
+  };
+
+}
+
+#endif /* _THREAD_SHARED_MUTEX_H_ */
@@ -0,0 +1,171 @@
+/*
+ * Check.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ */
+
+#ifndef _TEST_CHECK_H_
+#define _TEST_CHECK_H_
+
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <string>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include "../Source/Service/Service.h"
+
+/*
+ * every test is an executable of its own, built and run by the check target
+ * of the Build makefile. A failed CHECK is reported and counted, the test
+ * goes on and main returns NS_Test::result()
+ */
+#define CHECK(condition) \
+  NS_Test::check((condition), #condition, __FILE__, __LINE__)
+
+namespace NS_Test
+{
+
+  inline int& failures()
+  {
+    static int count = 0;
+    return count;
+  }
+
+  inline bool check(bool passed, const char* condition, const char* file,
+                    int line)
+  {
+    if(!passed)
+    {
+      printf("%s:%d: check failed: %s\n", file, line, condition);
+      fflush(stdout);
+      failures()++;
+    }
+    return passed;
+  }
+
+  /*
+   * exit status of a test, 0 when every check passed. Flushed, peers forked
+   * by a test leave through _exit()
+   */
+  inline int result(const char* test)
+  {
+    if(failures())
+    {
+      printf("%s: %d checks failed\n", test, failures());
+      fflush(stdout);
+      return 1;
+    }
+
+    printf("%s: passed\n", test);
+    fflush(stdout);
+    return 0;
+  }
+
+  /*
+   * wait for a peer process forked by the test, true if it exited with 0
+   */
+  inline bool joinProcess(pid_t pid)
+  {
+    int status = 0;
+    if(waitpid(pid, &status, 0) != pid)
+    {
+      return false;
+    }
+
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+  }
+
+  /*
+   * one byte through a pipe, to step forked peers in lock step
+   */
+  inline void signal(int fd)
+  {
+    char token = 0;
+    if(write(fd, &token, 1) != 1)
+    {
+      perror("signal");
+    }
+  }
+
+  inline void await(int fd)
+  {
+    char token;
+    if(read(fd, &token, 1) != 1)
+    {
+      perror("await");
+    }
+  }
+
+  /*
+   * wait for the ready signal of count peers
+   */
+  inline void awaitPeers(int fd, int count)
+  {
+    for(int i = 0; i < count; i++)
+    {
+      await(fd);
+    }
+  }
+
+  /*
+   * a pipe the test and its peers signal each other through, the test
+   * leaves with status 1 when none can be made
+   */
+  struct Pipe
+  {
+    int reader;
+    int writer;
+
+    Pipe()
+    {
+      int fds[2];
+      if(pipe(fds))
+      {
+        perror("pipe");
+        _exit(1);
+      }
+      reader = fds[0];
+      writer = fds[1];
+    }
+  };
+
+  /*
+   * run peer() in a process of its own, which exits with what it returns.
+   * Peers are forked before the test starts any thread
+   */
+  template< typename Peer >
+  inline pid_t forkPeer(Peer peer)
+  {
+    pid_t pid = fork();
+    if(pid == 0)
+    {
+      _exit(peer());
+    }
+    return pid;
+  }
+
+  /*
+   * drop what an earlier run left of a topic or a service, and what this
+   * one made
+   */
+  inline void removeTopic(const std::string& name)
+  {
+    boost::interprocess::shared_memory_object::remove(name.c_str());
+    boost::interprocess::shared_memory_object::remove(
+        (name + "_DS").c_str());
+  }
+
+  inline void removeService(const std::string& name)
+  {
+    boost::interprocess::shared_memory_object::remove(name.c_str());
+    for(uint32_t i = 0; i < NS_Service::SERVICE_SLOTS; i++)
+    {
+      boost::interprocess::shared_memory_object::remove(
+          NS_Service::serviceArenaName(name, i).c_str());
+    }
+  }
+
+}
+
+#endif /* _TEST_CHECK_H_ */
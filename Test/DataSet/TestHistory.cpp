@@ -0,0 +1,202 @@
+/*
+ * TestHistory.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ */
+
+/*
+ * subscriber history: a handshake publish returns only once a KEEP_ALL
+ * subscriber ran its callback, while LATEST_ONLY and keep-last subscribers
+ * never hold the publisher back and get the newest samples only
+ */
+
+#include <poll.h>
+#include <time.h>
+#include <vector>
+#include <boost/bind.hpp>
+#include "../Check.h"
+#include "../../Source/DataSet/Publisher.h"
+#include "../../Source/DataSet/Subscriber.h"
+#include "../../Source/DataSet/DataType/Odometry.h"
+
+using namespace NS_DataSet;
+using NS_DataType::Odometry;
+
+namespace
+{
+  const char* KEEP_ALL_TOPIC = "TestHistoryAll";
+  const char* LATEST_TOPIC = "TestHistoryLatest";
+  const char* KEEP_LAST_TOPIC = "TestHistoryLast";
+
+  const uint32_t SAMPLES = 50;
+  const uint32_t KEEP_LAST = 4;
+
+  int ack_fd;
+  int entered_fd;
+  int release_fd;
+
+  std::vector< uint32_t > ids;
+
+  /*
+   * acknowledge every sample to the publisher from within the callback
+   */
+  void onAcked(Odometry& odometry)
+  {
+    uint32_t id = odometry.header.seq;
+    usleep(2000);
+    ids.push_back(id);
+    if(write(ack_fd, &id, sizeof(id)) != sizeof(id))
+    {
+      perror("write");
+    }
+  }
+
+  /*
+   * held in the callback of the first sample until the publisher is done
+   */
+  void onHeld(Odometry& odometry)
+  {
+    if(ids.empty())
+    {
+      NS_Test::signal(entered_fd);
+      NS_Test::await(release_fd);
+    }
+    ids.push_back(odometry.header.seq);
+  }
+
+  void settle(uint32_t last_id)
+  {
+    for(int i = 0; i < 300; i++)
+    {
+      if(!ids.empty() && ids.back() == last_id)
+      {
+        break;
+      }
+      usleep(10000);
+    }
+    usleep(50000);
+  }
+
+  int keepAllSubscriber(int ready)
+  {
+    Subscriber< Odometry > subscriber(KEEP_ALL_TOPIC, onAcked,
+                                      DATASET_KEEP_ALL);
+    NS_Test::signal(ready);
+    settle(SAMPLES);
+
+    CHECK(ids.size() == SAMPLES);
+    for(uint32_t i = 0; i < ids.size(); i++)
+    {
+      CHECK(ids[i] == i + 1);
+    }
+    CHECK(subscriber.getLost() == 0);
+    CHECK(subscriber.getConflated() == 0);
+    return NS_Test::result("TestHistory keep all subscriber");
+  }
+
+  int heldSubscriber(int ready, const char* topic, uint32_t history)
+  {
+    Subscriber< Odometry > subscriber(topic, onHeld, history);
+    NS_Test::signal(ready);
+    settle(SAMPLES);
+
+    /*
+     * the first sample, then the newest history ones pending after it
+     */
+    CHECK(ids.size() == 1 + history);
+    CHECK(ids.front() == 1);
+    for(uint32_t i = 1; i < ids.size(); i++)
+    {
+      CHECK(ids[i] == SAMPLES - history + i);
+    }
+    CHECK(subscriber.getLost() == 0);
+    CHECK(subscriber.getConflated() == SAMPLES - 1 - history);
+    return NS_Test::result(topic);
+  }
+
+  double now()
+  {
+    struct timespec spec;
+    clock_gettime(CLOCK_MONOTONIC, &spec);
+    return spec.tv_sec + spec.tv_nsec * 1e-9;
+  }
+
+  /*
+   * publish SAMPLES to a subscriber held in its first callback, none of the
+   * publishes may wait for it
+   */
+  void publishPastHeld(const char* topic, DataSetMode mode, int entered,
+                       int release)
+  {
+    Publisher< Odometry > publisher(topic, mode);
+    Odometry odometry;
+    odometry.header.seq = 1;
+    CHECK(publisher.publish(odometry));
+    NS_Test::await(entered);
+
+    double start = now();
+    for(uint32_t id = 2; id <= SAMPLES; id++)
+    {
+      odometry.header.seq = id;
+      CHECK(publisher.publish(odometry));
+    }
+    CHECK(now() - start < DATASET_DEFAULT_TIMEOUT / 1000.0);
+
+    NS_Test::signal(release);
+  }
+}
+
+int main()
+{
+  NS_Test::removeTopic(KEEP_ALL_TOPIC);
+  NS_Test::removeTopic(LATEST_TOPIC);
+  NS_Test::removeTopic(KEEP_LAST_TOPIC);
+
+  NS_Test::Pipe ready, acks, entered, release;
+  ack_fd = acks.writer;
+  entered_fd = entered.writer;
+  release_fd = release.reader;
+
+  pid_t keep_all =
+      NS_Test::forkPeer(boost::bind(keepAllSubscriber, ready.writer));
+  pid_t latest = NS_Test::forkPeer(
+      boost::bind(heldSubscriber, ready.writer, LATEST_TOPIC,
+                  (uint32_t)DATASET_LATEST_ONLY));
+  pid_t keep_last = NS_Test::forkPeer(
+      boost::bind(heldSubscriber, ready.writer, KEEP_LAST_TOPIC, KEEP_LAST));
+  NS_Test::awaitPeers(ready.reader, 3);
+
+  /*
+   * each handshake publish returns after the subscriber acknowledged it
+   */
+  {
+    Publisher< Odometry > publisher(KEEP_ALL_TOPIC);
+    publisher.setTimeout(1000);
+    for(uint32_t id = 1; id <= SAMPLES; id++)
+    {
+      Odometry odometry;
+      odometry.header.seq = id;
+      CHECK(publisher.publish(odometry));
+
+      struct pollfd acked = { acks.reader, POLLIN, 0 };
+      uint32_t ack = 0;
+      CHECK(poll(&acked, 1, 0) == 1);
+      CHECK(read(acks.reader, &ack, sizeof(ack)) == sizeof(ack) && ack == id);
+    }
+    CHECK(NS_Test::joinProcess(keep_all));
+  }
+
+  publishPastHeld(LATEST_TOPIC, DATASET_MODE_HANDSHAKE, entered.reader,
+                  release.writer);
+  CHECK(NS_Test::joinProcess(latest));
+
+  publishPastHeld(KEEP_LAST_TOPIC, DATASET_MODE_RING, entered.reader,
+                  release.writer);
+  CHECK(NS_Test::joinProcess(keep_last));
+
+  NS_Test::removeTopic(KEEP_ALL_TOPIC);
+  NS_Test::removeTopic(LATEST_TOPIC);
+  NS_Test::removeTopic(KEEP_LAST_TOPIC);
+  return NS_Test::result("TestHistory");
+}
@@ -0,0 +1,321 @@
+/*
+ * TestRing.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ */
+
+/*
+ * ring transport: a subscriber in another process which falls behind loses
+ * slots but never sees a torn one, and a slot the publisher is rewriting
+ * (odd version) is rejected and counted as lost. While the segment grows no
+ * slot from before looks valid under the new generation, and an in-place
+ * view into the segment it outgrew is no longer intact
+ */
+
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include "../Check.h"
+#include "../../Source/DataSet/Publisher.h"
+#include "../../Source/DataSet/Subscriber.h"
+#include "../../Source/DataSet/DataType/LaserScan.h"
+
+using namespace NS_DataSet;
+using NS_DataType::LaserScan;
+
+namespace
+{
+  const char* STRESS_TOPIC = "TestRing";
+  const char* TORN_TOPIC = "TestRingTorn";
+  const char* GROWTH_TOPIC = "TestRingGrowth";
+
+  const uint32_t STRESS_SAMPLES = 2000;
+  const uint32_t TORN_SAMPLES = 40;
+
+  /*
+   * sample id is stored in every float of the sample, a torn copy mixes ids
+   */
+  void makeScan(LaserScan& scan, uint32_t id)
+  {
+    scan.range_min = (float)id;
+    scan.ranges.assign(1 + (id * 7919) % 2000, (float)id);
+    scan.intensities.assign(id % 97, (float)id);
+  }
+
+  bool wholeScan(const LaserScan& scan, uint32_t id)
+  {
+    if(scan.ranges.size() != 1 + (id * 7919) % 2000
+        || scan.intensities.size() != id % 97)
+    {
+      return false;
+    }
+
+    for(size_t i = 0; i < scan.ranges.size(); i++)
+    {
+      if(scan.ranges[i] != (float)id)
+      {
+        return false;
+      }
+    }
+    for(size_t i = 0; i < scan.intensities.size(); i++)
+    {
+      if(scan.intensities[i] != (float)id)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  volatile uint32_t received = 0;
+  uint32_t last_id = 0;
+  uint32_t torn = 0;
+  uint32_t reordered = 0;
+
+  void onStressScan(LaserScan& scan)
+  {
+    uint32_t id = (uint32_t)scan.range_min;
+    if(!wholeScan(scan, id))
+    {
+      torn++;
+    }
+    if(id <= last_id)
+    {
+      reordered++;
+    }
+    last_id = id;
+    usleep(id % 5 ? 0 : 200);
+    NS_NaviCommon::atomicFetchAdd(&received, 1U);
+  }
+
+  /*
+   * wait until every published sample was either delivered or lost
+   */
+  void settle(SubscriberBase& subscriber, uint32_t samples)
+  {
+    for(int i = 0; i < 500; i++)
+    {
+      if(NS_NaviCommon::atomicLoad(&received) + subscriber.getLost()
+          >= samples)
+      {
+        break;
+      }
+      usleep(10000);
+    }
+  }
+
+  int stressSubscriber(int ready)
+  {
+    Subscriber< LaserScan > subscriber(STRESS_TOPIC, onStressScan);
+    NS_Test::signal(ready);
+
+    settle(subscriber, STRESS_SAMPLES);
+
+    CHECK(torn == 0);
+    CHECK(reordered == 0);
+    CHECK(received > 0);
+    CHECK(received + subscriber.getLost() == STRESS_SAMPLES);
+    return NS_Test::result("TestRing subscriber");
+  }
+
+  int entered_fd;
+  int release_fd;
+  bool poisoned_delivered = false;
+
+  void onTornScan(LaserScan& scan)
+  {
+    uint32_t id = (uint32_t)scan.range_min;
+    if(id == 1)
+    {
+      NS_Test::signal(entered_fd);
+      NS_Test::await(release_fd);
+    }
+    if(id == TORN_SAMPLES)
+    {
+      poisoned_delivered = true;
+    }
+    CHECK(wholeScan(scan, id));
+    NS_NaviCommon::atomicFetchAdd(&received, 1U);
+  }
+
+  int tornSubscriber(int ready)
+  {
+    Subscriber< LaserScan > subscriber(TORN_TOPIC, onTornScan);
+    NS_Test::signal(ready);
+
+    settle(subscriber, TORN_SAMPLES);
+
+    CHECK(!poisoned_delivered);
+    CHECK(received + subscriber.getLost() == TORN_SAMPLES);
+    CHECK(subscriber.getLost() > 0);
+    return NS_Test::result("TestRing torn subscriber");
+  }
+
+  /*
+   * generation before the publish that grows the segment in the high half,
+   * the sequence of that publish in the low one
+   */
+  volatile uint64_t growth = 0;
+  volatile bool watching = true;
+  uint32_t stale = 0;
+
+  /*
+   * a lock-free reader of the control block: once the grown generation is
+   * visible, a slot written before the growth must be odd or cleared, its
+   * data is not at its offset in the grown segment
+   */
+  void watchGrowth(DataSetOperation* operation)
+  {
+    while(NS_NaviCommon::atomicLoad(&watching))
+    {
+      uint64_t marker = NS_NaviCommon::atomicLoad(&growth);
+      uint32_t sequence = (uint32_t)marker;
+      uint32_t generation = NS_NaviCommon::atomicLoad(&operation->generation);
+      if(generation != (uint32_t)(marker >> 32) + 1)
+      {
+        continue;
+      }
+
+      for(uint32_t i = 0; i < slotCount(operation->mode); i++)
+      {
+        DataSetSlot& slot = operation->slots[i];
+        uint32_t version = NS_NaviCommon::atomicLoad(&slot.version);
+        if(version & 1)
+        {
+          continue;
+        }
+
+        uint32_t written = slot.sequence;
+        NS_NaviCommon::acquireFence();
+        if(written != 0 && (int32_t)(written - sequence) < 0
+            && NS_NaviCommon::atomicLoad(&slot.version) == version
+            && NS_NaviCommon::atomicLoad(&operation->generation)
+                == generation)
+        {
+          stale++;
+        }
+      }
+    }
+  }
+}
+
+int main()
+{
+  /*
+   * an in-place view stays intact only while both its slot version and the
+   * generation of the segment it points into are unchanged
+   */
+  {
+    uint8_t data = 0;
+    uint32_t version = 2;
+    uint32_t generation = 1;
+    DataSetView view(&data, 1, 1, &version, version, &generation, generation);
+    CHECK(view.intact());
+
+    generation++;
+    CHECK(!view.intact());
+
+    generation--;
+    version += 2;
+    CHECK(!view.intact());
+  }
+
+  NS_Test::removeTopic(STRESS_TOPIC);
+  NS_Test::removeTopic(TORN_TOPIC);
+
+  NS_Test::Pipe ready, entered, release;
+  entered_fd = entered.writer;
+  release_fd = release.reader;
+
+  pid_t stress =
+      NS_Test::forkPeer(boost::bind(stressSubscriber, ready.writer));
+  pid_t torn_peer =
+      NS_Test::forkPeer(boost::bind(tornSubscriber, ready.writer));
+  NS_Test::awaitPeers(ready.reader, 2);
+
+  {
+    Publisher< LaserScan > publisher(STRESS_TOPIC, DATASET_MODE_RING);
+    for(uint32_t id = 1; id <= STRESS_SAMPLES; id++)
+    {
+      LaserScan scan;
+      makeScan(scan, id);
+      CHECK(publisher.publish(scan));
+    }
+    CHECK(NS_Test::joinProcess(stress));
+  }
+
+  {
+    Publisher< LaserScan > publisher(TORN_TOPIC, DATASET_MODE_RING);
+    LaserScan scan;
+    makeScan(scan, 1);
+    CHECK(publisher.publish(scan));
+
+    /*
+     * the subscriber is held in the callback of the first sample while the
+     * ring wraps, then the newest slot is marked as being rewritten
+     */
+    NS_Test::await(entered.reader);
+    for(uint32_t id = 2; id <= TORN_SAMPLES; id++)
+    {
+      makeScan(scan, id);
+      CHECK(publisher.publish(scan));
+    }
+
+    mapped_region region;
+    DataSetOperation* operation = attachOperation(TORN_TOPIC, region);
+    CHECK(operation != NULL);
+    if(operation)
+    {
+      DataSetSlot& slot =
+          operation->slots[operation->head % slotCount(operation->mode)];
+      CHECK(slot.sequence == TORN_SAMPLES);
+      NS_NaviCommon::atomicStore(&slot.version, slot.version + 1);
+    }
+
+    NS_Test::signal(release.writer);
+    CHECK(NS_Test::joinProcess(torn_peer));
+  }
+
+  /*
+   * the sample size doubles until the segment has grown many times, the
+   * ring holds samples of the previous size whenever it grows. Latched, so
+   * the slots are written without a subscriber
+   */
+  NS_Test::removeTopic(GROWTH_TOPIC);
+  {
+    Publisher< LaserScan > publisher(GROWTH_TOPIC, DATASET_MODE_RING, 0, true);
+    LaserScan scan;
+    CHECK(publisher.publish(scan));
+
+    mapped_region region;
+    DataSetOperation* operation = attachOperation(GROWTH_TOPIC, region);
+    CHECK(operation != NULL);
+    if(operation)
+    {
+      uint32_t first = operation->generation;
+      boost::thread watcher(boost::bind(watchGrowth, operation));
+      for(size_t ranges = 16; ranges <= (1 << 18); ranges *= 2)
+      {
+        scan.ranges.assign(ranges, 1.0f);
+        NS_NaviCommon::atomicStore(
+            &growth,
+            ((uint64_t)operation->generation << 32) | (operation->head + 1));
+        for(int i = 0; i < 4; i++)
+        {
+          CHECK(publisher.publish(scan));
+        }
+      }
+      NS_NaviCommon::atomicStore(&watching, false);
+      watcher.join();
+
+      CHECK(operation->generation - first > 8);
+      CHECK(stale == 0);
+    }
+  }
+
+  NS_Test::removeTopic(STRESS_TOPIC);
+  NS_Test::removeTopic(TORN_TOPIC);
+  NS_Test::removeTopic(GROWTH_TOPIC);
+  return NS_Test::result("TestRing");
+}
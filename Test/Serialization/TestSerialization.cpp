@@ -0,0 +1,838 @@
+/*
+ * TestSerialization.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ */
+
+/*
+ * the wire format of the messages copied in one piece: each one has to
+ * serialize to the same bytes as its fields written one by one, at any
+ * alignment, alone and in vectors, and read back to the same message.
+ * Messages holding long vectors of them, like point clouds and grids, keep
+ * their wire format too, as do vectors of scalars, Time and Duration, and
+ * data of the other byte order reads back to the same values, through
+ * vectors and array views alike. Serializing
+ * in a single pass has to give the same bytes as measuring the message
+ * first, whether it fits the buffer given or not. Types without an MD5Sum
+ * sharing a name but not a layout must not share a type signature either
+ */
+
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "../Check.h"
+#include "../../Source/Serialization/Serialization.h"
+#include "../../Source/DataSet/DataType/Point.h"
+#include "../../Source/DataSet/DataType/Quaternion.h"
+#include "../../Source/DataSet/DataType/Vector3.h"
+#include "../../Source/DataSet/DataType/Pose.h"
+#include "../../Source/DataSet/DataType/Twist.h"
+#include "../../Source/DataSet/DataType/Transform.h"
+#include "../../Source/DataSet/DataType/PoseWithCovarianceStamped.h"
+#include "../../Source/DataSet/DataType/LaserScan.h"
+#include "../../Source/DataSet/DataType/Point32.h"
+#include "../../Source/DataSet/DataType/MapMetaData.h"
+#include "../../Source/DataSet/DataType/Polygon.h"
+#include "../../Source/DataSet/DataType/PointCloud.h"
+#include "../../Source/DataSet/DataType/OccupancyGrid.h"
+#include "../../Source/Common/TypeSignature.h"
+
+namespace NS_TestType
+{
+  /*
+   * fixed size but not simple, the padding after id keeps it from being
+   * copied whole: vectors of it are read through one block
+   */
+  struct Reading
+  {
+    uint16_t id;
+    double value;
+  };
+
+  /*
+   * three builds of one message without an MD5Sum: a wider field, then a
+   * field of another type with the same size
+   */
+  struct Tagged
+  {
+    uint32_t id;
+  };
+
+  struct TaggedWide
+  {
+    uint64_t id;
+  };
+
+  struct TaggedFloat
+  {
+    float id;
+  };
+}
+
+#define TAGGED_TRAITS(msg, definition) \
+  template< > struct MD5Sum< msg > \
+  { \
+    static const char* value() { return ""; } \
+    static const uint64_t static_value1 = 0; \
+    static const uint64_t static_value2 = 0; \
+  }; \
+  template< > struct DataType< msg > \
+  { \
+    static const char* value() { return "TestType/Tagged"; } \
+  }; \
+  template< > struct Definition< msg > \
+  { \
+    static const char* value() { return definition; } \
+  }; \
+  template< > struct IsFixedSize< msg > : TrueType \
+  { \
+  };
+
+namespace NS_NaviCommon
+{
+  template< >
+  struct IsFixedSize< NS_TestType::Reading > : TrueType
+  {
+  };
+
+  template< >
+  struct IsMessage< NS_TestType::Reading > : TrueType
+  {
+  };
+
+  template< >
+  struct Serializer< NS_TestType::Reading >
+  {
+    template< typename Stream, typename T >
+    inline static void allInOne(Stream& stream, T m)
+    {
+      stream.next(m.id);
+      stream.next(m.value);
+    }
+
+    DECLARE_ALLINONE_SERIALIZER
+  };
+
+  TAGGED_TRAITS(NS_TestType::Tagged, "uint32 id\n")
+  TAGGED_TRAITS(NS_TestType::TaggedWide, "uint64 id\n")
+  TAGGED_TRAITS(NS_TestType::TaggedFloat, "float32 id\n")
+}
+
+using namespace NS_NaviCommon;
+using namespace NS_DataType;
+using NS_TestType::Reading;
+
+namespace
+{
+  /*
+   * the expected encoding, built field by field in host byte order, or in
+   * the other one when swapped
+   */
+  struct Reference
+  {
+    std::vector< uint8_t > bytes;
+    bool swapped;
+
+    explicit Reference(bool swapped = false)
+        : swapped(swapped)
+    {
+    }
+
+    template< typename T >
+    Reference& operator()(T value)
+    {
+      const uint8_t* begin = reinterpret_cast< const uint8_t* >(&value);
+      size_t start = bytes.size();
+      bytes.insert(bytes.end(), begin, begin + sizeof(T));
+      if(swapped)
+      {
+        std::reverse(bytes.begin() + start, bytes.end());
+      }
+      return *this;
+    }
+
+    Reference& operator()(const std::string& value)
+    {
+      (*this)((uint32_t)value.size());
+      bytes.insert(bytes.end(), value.begin(), value.end());
+      return *this;
+    }
+
+    Reference& operator()(const Reference& fields)
+    {
+      bytes.insert(bytes.end(), fields.bytes.begin(), fields.bytes.end());
+      return *this;
+    }
+  };
+
+  Reference encode(const Point& m)
+  {
+    return Reference()(m.x)(m.y)(m.z);
+  }
+
+  Reference encode(const Quaternion& m)
+  {
+    return Reference()(m.x)(m.y)(m.z)(m.w);
+  }
+
+  Reference encode(const Vector3& m)
+  {
+    return Reference()(m.x)(m.y)(m.z);
+  }
+
+  Reference encode(const Pose& m)
+  {
+    return Reference()(encode(m.position))(encode(m.orientation));
+  }
+
+  Reference encode(const Twist& m)
+  {
+    return Reference()(encode(m.linear))(encode(m.angular));
+  }
+
+  Reference encode(const Transform& m)
+  {
+    return Reference()(encode(m.translation))(encode(m.rotation));
+  }
+
+  Reference encode(const DataHeader& m)
+  {
+    return Reference()(m.seq)(m.stamp.sec)(m.stamp.nsec)(m.frame_id);
+  }
+
+  Reference encode(const PoseWithCovarianceStamped& m)
+  {
+    Reference reference;
+    reference(encode(m.header))(encode(m.pose));
+    for(int i = 0; i < 36; i++)
+    {
+      reference(m.covariance[i]);
+    }
+    return reference;
+  }
+
+  template< typename T >
+  Reference encodeTime(const T& m, bool swapped = false)
+  {
+    return Reference(swapped)(m.sec)(m.nsec);
+  }
+
+  Reference encode(const Time& m)
+  {
+    return encodeTime(m);
+  }
+
+  Reference encode(const Duration& m)
+  {
+    return encodeTime(m);
+  }
+
+  Reference encode(const Reading& m)
+  {
+    return Reference()(m.id)(m.value);
+  }
+
+  Reference encode(const Point32& m)
+  {
+    return Reference()(m.x)(m.y)(m.z);
+  }
+
+  Reference encode(const MapMetaData& m)
+  {
+    return Reference()(m.map_load_time.sec)(m.map_load_time.nsec)(
+        m.resolution)(m.width)(m.height)(encode(m.origin));
+  }
+
+  template< typename T >
+  Reference encodeScalars(const std::vector< T >& v, bool swapped = false)
+  {
+    Reference reference(swapped);
+    reference((uint32_t)v.size());
+    for(size_t i = 0; i < v.size(); i++)
+    {
+      reference(v[i]);
+    }
+    return reference;
+  }
+
+  Reference encode(const ChannelFloat32& m)
+  {
+    return Reference()(m.name)(m.values);
+  }
+
+  template< typename M >
+  Reference encodeVector(const std::vector< M >& v)
+  {
+    Reference reference;
+    reference((uint32_t)v.size());
+    for(size_t i = 0; i < v.size(); i++)
+    {
+      reference(encode(v[i]));
+    }
+    return reference;
+  }
+
+  Reference encode(const Polygon& m)
+  {
+    return encodeVector(m.points);
+  }
+
+  Reference encode(const PointCloud& m)
+  {
+    return Reference()(encode(m.header))(encodeVector(m.points))(
+        encodeVector(m.channels));
+  }
+
+  Reference encode(const OccupancyGrid& m)
+  {
+    return Reference()(encode(m.header))(encode(m.info))(
+        encodeScalars(m.data));
+  }
+
+  /*
+   * serialize m one byte past an aligned address and compare with expected,
+   * then read it back and serialize the copy again
+   */
+  template< typename M >
+  void checkEncoding(const char* name, const M& m, const Reference& expected)
+  {
+    const std::vector< uint8_t >& bytes = expected.bytes;
+    uint32_t length = serializationLength(m);
+    if(!CHECK(length == bytes.size()))
+    {
+      printf("  %s: %u bytes, expected %u\n", name, length,
+             (uint32_t)bytes.size());
+      return;
+    }
+
+    std::vector< uint8_t > buffer(length + 1);
+    OStream out(&buffer[1], length);
+    serialize(out, m);
+    CHECK(out.getLength() == 0);
+    if(!CHECK(memcmp(&buffer[1], &bytes[0], length) == 0))
+    {
+      printf("  %s: serialized bytes differ\n", name);
+    }
+
+    M copy;
+    IStream in(&buffer[1], length);
+    deserialize(in, copy);
+    CHECK(in.getLength() == 0);
+
+    std::vector< uint8_t > again(length);
+    OStream out_again(&again[0], length);
+    serialize(out_again, copy);
+    if(!CHECK(again == bytes))
+    {
+      printf("  %s: does not read back\n", name);
+    }
+  }
+
+  /*
+   * a simple message alone and in vectors of a few lengths
+   */
+  template< typename M >
+  void checkSimple(const char* name, const std::vector< M >& samples)
+  {
+    CHECK(IsSimple< M >::value);
+    CHECK(IsFixedSize< M >::value);
+
+    for(size_t i = 0; i < samples.size(); i++)
+    {
+      checkEncoding(name, samples[i], encode(samples[i]));
+    }
+
+    for(size_t count = 0; count <= samples.size(); count++)
+    {
+      std::vector< M > v(samples.begin(), samples.begin() + count);
+      checkEncoding(name, v, encodeVector(v));
+    }
+  }
+
+  /*
+   * distinct values for every field, so a swapped or shifted one shows
+   */
+  double value(int sample, int field)
+  {
+    return sample * 100.0 + field + 0.125;
+  }
+
+  Point makePoint(int sample, int first)
+  {
+    Point m;
+    m.x = value(sample, first);
+    m.y = value(sample, first + 1);
+    m.z = value(sample, first + 2);
+    return m;
+  }
+
+  Quaternion makeQuaternion(int sample, int first)
+  {
+    Quaternion m;
+    m.x = value(sample, first);
+    m.y = value(sample, first + 1);
+    m.z = value(sample, first + 2);
+    m.w = value(sample, first + 3);
+    return m;
+  }
+
+  Vector3 makeVector3(int sample, int first)
+  {
+    Vector3 m;
+    m.x = value(sample, first);
+    m.y = value(sample, first + 1);
+    m.z = value(sample, first + 2);
+    return m;
+  }
+
+  Pose makePose(int sample)
+  {
+    Pose m;
+    m.position = makePoint(sample, 0);
+    m.orientation = makeQuaternion(sample, 3);
+    return m;
+  }
+
+  template< typename M >
+  std::vector< M > samples(M (*make)(int))
+  {
+    std::vector< M > v;
+    for(int i = 0; i < 5; i++)
+    {
+      v.push_back(make(i));
+    }
+    return v;
+  }
+
+  Point point(int sample)
+  {
+    return makePoint(sample, 0);
+  }
+
+  Quaternion quaternion(int sample)
+  {
+    return makeQuaternion(sample, 0);
+  }
+
+  Vector3 vector3(int sample)
+  {
+    return makeVector3(sample, 0);
+  }
+
+  Twist twist(int sample)
+  {
+    Twist m;
+    m.linear = makeVector3(sample, 0);
+    m.angular = makeVector3(sample, 3);
+    return m;
+  }
+
+  Transform transform(int sample)
+  {
+    Transform m;
+    m.translation = makeVector3(sample, 0);
+    m.rotation = makeQuaternion(sample, 3);
+    return m;
+  }
+
+  void checkFixedSizeTypes()
+  {
+    checkSimple("Point", samples(point));
+    checkSimple("Quaternion", samples(quaternion));
+    checkSimple("Vector3", samples(vector3));
+    checkSimple("Pose", samples(makePose));
+    checkSimple("Twist", samples(twist));
+    checkSimple("Transform", samples(transform));
+
+    /*
+     * not simple itself, its covariance is a fixed array copied element
+     * by element
+     */
+    PoseWithCovarianceStamped pose;
+    pose.header.seq = 7;
+    pose.header.stamp.sec = 1500000000;
+    pose.header.stamp.nsec = 250;
+    pose.header.frame_id = "map";
+    pose.pose = makePose(3);
+    for(int i = 0; i < 36; i++)
+    {
+      pose.covariance[i] = value(9, i);
+    }
+    checkEncoding("PoseWithCovarianceStamped", pose, encode(pose));
+  }
+
+  Point32 point32(int sample)
+  {
+    Point32 m;
+    m.x = (float)value(sample, 0);
+    m.y = (float)value(sample, 1);
+    m.z = (float)value(sample, 2);
+    return m;
+  }
+
+  MapMetaData mapMetaData(int sample)
+  {
+    MapMetaData m;
+    m.map_load_time.sec = 1500000000 + sample;
+    m.map_load_time.nsec = 1000 * sample + 1;
+    m.resolution = 0.05f * (sample + 1);
+    m.width = (int16_t)(100 * sample + 3);
+    m.height = (int16_t)(-7 - sample);
+    m.origin = makePose(sample);
+    return m;
+  }
+
+  /*
+   * messages holding vectors of simple messages, copied in bulk
+   */
+  void checkBulkTypes()
+  {
+    checkSimple("Point32", samples(point32));
+    checkSimple("MapMetaData", samples(mapMetaData));
+
+    const uint32_t counts[] = { 0, 1, 3, 1000 };
+    for(size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++)
+    {
+      Polygon polygon;
+      PointCloud cloud;
+      cloud.header.seq = counts[i];
+      cloud.header.frame_id = "laser";
+      for(uint32_t j = 0; j < counts[i]; j++)
+      {
+        polygon.points.push_back(point32(j));
+        cloud.points.push_back(point32(j + 1));
+      }
+      checkEncoding("Polygon", polygon, encode(polygon));
+
+      cloud.channels.resize(2);
+      cloud.channels[0].name = "intensity";
+      cloud.channels[0].values.assign(counts[i], 'v');
+      cloud.channels[1].name = "ring";
+      checkEncoding("PointCloud", cloud, encode(cloud));
+
+      OccupancyGrid grid;
+      grid.header.frame_id = "map";
+      grid.info = mapMetaData(i);
+      for(uint32_t j = 0; j < counts[i]; j++)
+      {
+        grid.data.push_back((char)(j % 3 ? 100 : -1));
+      }
+      checkEncoding("OccupancyGrid", grid, encode(grid));
+    }
+  }
+
+  /*
+   * the two pass encoding: measure, then write
+   */
+  /*
+   * bytes with the high bit set and no two alike, so a lost, shifted or
+   * unswapped byte shows
+   */
+  template< typename T >
+  T scalar(uint32_t sample)
+  {
+    return (T)(sample * 0x0102030507090B0DULL + 0x8F);
+  }
+
+  /*
+   * vectors long enough for the whole 16 byte blocks of the bulk copy,
+   * and short of a block by one or more elements
+   */
+  const uint32_t SCALAR_COUNTS[] = { 0, 1, 3, 4, 5, 17, 100 };
+
+  template< typename T >
+  void checkScalar(const char* name)
+  {
+    CHECK(IsSimple< T >::value);
+    CHECK(IsFixedSize< T >::value);
+
+    checkEncoding(name, scalar< T >(7), Reference()(scalar< T >(7)));
+    for(size_t i = 0; i < sizeof(SCALAR_COUNTS) / sizeof(SCALAR_COUNTS[0]);
+        i++)
+    {
+      std::vector< T > v;
+      for(uint32_t j = 0; j < SCALAR_COUNTS[i]; j++)
+      {
+        v.push_back(scalar< T >(j + 1));
+      }
+      checkEncoding(name, v, encodeScalars(v));
+    }
+  }
+
+  Time stamp(int sample)
+  {
+    return Time(1500000000 + sample, sample * 1000 + 7);
+  }
+
+  Duration duration(int sample)
+  {
+    return Duration(sample - 3, sample * 1000 + 7);
+  }
+
+  void checkScalarTypes()
+  {
+    checkScalar< char >("char");
+    checkScalar< int8_t >("int8_t");
+    checkScalar< uint8_t >("uint8_t");
+    checkScalar< int16_t >("int16_t");
+    checkScalar< uint16_t >("uint16_t");
+    checkScalar< int32_t >("int32_t");
+    checkScalar< uint32_t >("uint32_t");
+    checkScalar< int64_t >("int64_t");
+    checkScalar< uint64_t >("uint64_t");
+    checkScalar< float >("float");
+    checkScalar< double >("double");
+
+    checkSimple("Time", samples(stamp));
+    checkSimple("Duration", samples(duration));
+  }
+
+  /*
+   * read bytes of the other byte order one byte past an aligned address,
+   * the message has to come out as m
+   */
+  template< typename M >
+  void checkSwapped(const char* name, const M& m, const Reference& swapped)
+  {
+    std::vector< uint8_t > buffer(1);
+    buffer.insert(buffer.end(), swapped.bytes.begin(), swapped.bytes.end());
+
+    M copy;
+    ByteSwappedIStream in(&buffer[1], (uint32_t)swapped.bytes.size());
+    deserialize(in, copy);
+    CHECK(in.getLength() == 0);
+
+    if(!CHECK(serializationLength(copy) == serializationLength(m)))
+    {
+      printf("  %s: swapped read has the wrong length\n", name);
+      return;
+    }
+    std::vector< uint8_t > expected(serializationLength(m));
+    std::vector< uint8_t > got(expected.size());
+    OStream out_expected(&expected[0], (uint32_t)expected.size());
+    OStream out_got(&got[0], (uint32_t)got.size());
+    serialize(out_expected, m);
+    serialize(out_got, copy);
+    if(!CHECK(got == expected))
+    {
+      printf("  %s: swapped read differs\n", name);
+    }
+  }
+
+  template< typename T >
+  void checkSwappedScalar(const char* name)
+  {
+    for(size_t i = 0; i < sizeof(SCALAR_COUNTS) / sizeof(SCALAR_COUNTS[0]);
+        i++)
+    {
+      std::vector< T > v;
+      for(uint32_t j = 0; j < SCALAR_COUNTS[i]; j++)
+      {
+        v.push_back(scalar< T >(j + 1));
+      }
+      checkSwapped(name, v, encodeScalars(v, true));
+    }
+  }
+
+  Reading reading(int sample)
+  {
+    Reading m;
+    m.id = (uint16_t)(0x0102 + sample);
+    m.value = value(sample, 1);
+    return m;
+  }
+
+  void checkSwappedTypes()
+  {
+    checkSwappedScalar< int8_t >("swapped int8_t");
+    checkSwappedScalar< uint16_t >("swapped uint16_t");
+    checkSwappedScalar< int32_t >("swapped int32_t");
+    checkSwappedScalar< uint64_t >("swapped uint64_t");
+    checkSwappedScalar< float >("swapped float");
+    checkSwappedScalar< double >("swapped double");
+
+    /*
+     * simple messages are read field by field from a swapped stream
+     */
+    Reference times(true);
+    std::vector< Time > stamps = samples(stamp);
+    times((uint32_t)stamps.size());
+    for(size_t i = 0; i < stamps.size(); i++)
+    {
+      times(encodeTime(stamps[i], true));
+    }
+    checkSwapped("swapped Time", stamps, times);
+
+    Reference points(true);
+    std::vector< Point32 > cloud = samples(point32);
+    points((uint32_t)cloud.size());
+    for(size_t i = 0; i < cloud.size(); i++)
+    {
+      points(cloud[i].x)(cloud[i].y)(cloud[i].z);
+    }
+    checkSwapped("swapped Point32", cloud, points);
+
+    /*
+     * fixed-size messages which are not simple are read as one block, in
+     * the byte order of the stream
+     */
+    std::vector< Reading > log = samples(reading);
+    CHECK(!IsSimple< Reading >::value);
+    checkEncoding("Reading", log, encodeVector(log));
+
+    Reference readings(true);
+    readings((uint32_t)log.size());
+    for(size_t i = 0; i < log.size(); i++)
+    {
+      readings(log[i].id)(log[i].value);
+    }
+    checkSwapped("swapped Reading", log, readings);
+
+    /*
+     * views over arrays of the other byte order hand out swapped elements
+     */
+    std::vector< float > ranges;
+    for(uint32_t i = 0; i < 17; i++)
+    {
+      ranges.push_back(scalar< float >(i + 1));
+    }
+    Reference swapped_ranges = encodeScalars(ranges, true);
+    ByteSwappedIStream ranges_in(&swapped_ranges.bytes[0],
+                                 (uint32_t)swapped_ranges.bytes.size());
+    ArrayView< float > ranges_view = readArrayView< float >(ranges_in);
+    CHECK(ranges_in.getLength() == 0);
+    CHECK(ranges_view.size() == ranges.size());
+    for(uint32_t i = 0; i < ranges_view.size(); i++)
+    {
+      CHECK(ranges_view[i] == ranges[i]);
+    }
+    std::vector< float > ranges_copy;
+    ranges_view.copyTo(ranges_copy);
+    CHECK(ranges_copy == ranges);
+
+    ByteSwappedIStream points_in(&points.bytes[0],
+                                 (uint32_t)points.bytes.size());
+    ArrayView< Point32 > points_view = readArrayView< Point32 >(points_in);
+    CHECK(points_in.getLength() == 0);
+    std::vector< Point32 > points_copy;
+    points_view.copyTo(points_copy);
+    CHECK(points_copy.size() == cloud.size());
+    for(uint32_t i = 0; i < points_view.size() && i < cloud.size(); i++)
+    {
+      CHECK(points_view[i].x == cloud[i].x && points_view[i].y == cloud[i].y
+          && points_view[i].z == cloud[i].z);
+      CHECK(points_copy[i].x == cloud[i].x && points_copy[i].y == cloud[i].y
+          && points_copy[i].z == cloud[i].z);
+    }
+  }
+
+  template< typename M >
+  std::vector< uint8_t > twoPass(const M& m)
+  {
+    std::vector< uint8_t > bytes(serializationLength(m));
+    OStream out(bytes.empty() ? NULL : &bytes[0], bytes.size());
+    serialize(out, m);
+    return bytes;
+  }
+
+  /*
+   * serialize m in one pass into a buffer of capacity bytes, the stream
+   * spills into a buffer of its own when that is too small
+   */
+  template< typename M >
+  void checkSinglePass(const char* name, const M& m, uint32_t capacity)
+  {
+    std::vector< uint8_t > expected = twoPass(m);
+    std::vector< uint8_t > buffer(capacity + 1);
+
+    GrowableOStream out(capacity ? &buffer[0] : NULL, capacity);
+    serialize(out, m);
+
+    CHECK(out.spilled() == (expected.size() > capacity));
+    CHECK(!out.spilled() || out.data() != &buffer[0]);
+    if(!CHECK(out.size() == expected.size()))
+    {
+      printf("  %s: %u bytes, expected %u\n", name, out.size(),
+             (uint32_t)expected.size());
+      return;
+    }
+
+    if(!CHECK(std::vector< uint8_t >(out.data(), out.data() + out.size())
+        == expected))
+    {
+      printf("  %s: single pass bytes differ into %u bytes\n", name,
+             capacity);
+    }
+  }
+
+  LaserScan makeScan(uint32_t ranges)
+  {
+    LaserScan scan;
+    scan.header.seq = ranges;
+    scan.header.frame_id = "laser";
+    scan.angle_min = -1.5f;
+    scan.angle_increment = 0.01f;
+    for(uint32_t i = 0; i < ranges; i++)
+    {
+      scan.ranges.push_back(i * 0.5f);
+      scan.intensities.push_back(i % 7 ? i * 0.25f : 0.0f);
+    }
+    return scan;
+  }
+
+  void checkSinglePassTypes()
+  {
+    const uint32_t ranges[] = { 0, 1, 100, 3000 };
+    for(size_t i = 0; i < sizeof(ranges) / sizeof(ranges[0]); i++)
+    {
+      LaserScan scan = makeScan(ranges[i]);
+      uint32_t length = serializationLength(scan);
+
+      checkSinglePass("LaserScan", scan, length);
+      checkSinglePass("LaserScan", scan, length + 64);
+      checkSinglePass("LaserScan", scan, length / 2);
+      checkSinglePass("LaserScan", scan, 0);
+    }
+
+    checkSinglePass("Pose", makePose(1), 16);
+    checkSinglePass("Pose", makePose(1), 56);
+  }
+
+  bool sameSignature(const TypeSignature& a, const TypeSignature& b)
+  {
+    return a.hash[0] == b.hash[0] && a.hash[1] == b.hash[1];
+  }
+
+  void checkTypeSignatures()
+  {
+    TypeSignature tagged = typeSignature< NS_TestType::Tagged >();
+    TypeSignature wide = typeSignature< NS_TestType::TaggedWide >();
+    TypeSignature real = typeSignature< NS_TestType::TaggedFloat >();
+
+    CHECK(tagged.hash[0] != 0 || tagged.hash[1] != 0);
+    CHECK(sameSignature(tagged, typeSignature< NS_TestType::Tagged >()));
+    CHECK(strcmp(tagged.name, wide.name) == 0);
+    CHECK(!sameSignature(tagged, wide));
+    CHECK(!sameSignature(tagged, real));
+    CHECK(!sameSignature(wide, real));
+
+    /*
+     * the MD5Sum is taken as it is when there is one
+     */
+    TypeSignature point = typeSignature< Point >();
+    CHECK(point.hash[0] == MD5Sum< Point >::static_value1);
+    CHECK(point.hash[1] == MD5Sum< Point >::static_value2);
+  }
+}
+
+int main()
+{
+  checkFixedSizeTypes();
+  checkSinglePassTypes();
+  checkBulkTypes();
+  checkScalarTypes();
+  checkSwappedTypes();
+  checkTypeSignatures();
+  return NS_Test::result("TestSerialization");
+}
@@ -0,0 +1,186 @@
+/*
+ * TestMapSync.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ */
+
+/*
+ * incremental map synchronization over a ServiceMapUpdate server: a replica
+ * behind by a few changes gets just their patches, one which is up to date
+ * gets nothing, and one whose version is no longer remembered, or would need
+ * too much of the map patched, gets the whole map
+ */
+
+#include <boost/bind.hpp>
+#include "../Check.h"
+#include "../../Source/Service/Server.h"
+#include "../../Source/Service/Client.h"
+#include "../../Source/Service/MapSync.h"
+
+using namespace NS_Service;
+using NS_DataType::OccupancyGrid;
+using NS_DataType::OccupancyGridUpdate;
+using NS_ServiceType::ServiceMapUpdate;
+
+namespace
+{
+  const char* SERVICE_NAME = "TestMapSync";
+
+  const int16_t WIDTH = 64;
+  const int16_t HEIGHT = 48;
+  const size_t HISTORY = 8;
+
+  OccupancyGrid makeMap(char fill)
+  {
+    OccupancyGrid map;
+    map.header.frame_id = "map";
+    map.info.resolution = 0.05f;
+    map.info.width = WIDTH;
+    map.info.height = HEIGHT;
+    map.data.assign((size_t)WIDTH * HEIGHT, fill);
+    return map;
+  }
+
+  OccupancyGridUpdate patch(int x, int y, int width, int height, char value)
+  {
+    OccupancyGridUpdate update;
+    update.x = x;
+    update.y = y;
+    update.width = width;
+    update.height = height;
+    update.data.assign((size_t)width * height, value);
+    return update;
+  }
+
+  /*
+   * the copy of the map a caller keeps and the version it is at
+   */
+  struct Replica
+  {
+    OccupancyGrid map;
+    uint64_t version;
+  };
+
+  /*
+   * ask for the changes since the version of the replica and apply them,
+   * srv keeps the reply
+   */
+  bool sync(Client< ServiceMapUpdate >& client, Replica& replica,
+            ServiceMapUpdate& srv)
+  {
+    srv = ServiceMapUpdate();
+    srv.version = replica.version;
+    return client.call(srv, 2000)
+        && applyMapSync(srv, replica.map, replica.version);
+  }
+
+  bool sameMap(MapSync& source, const Replica& replica)
+  {
+    OccupancyGrid map;
+    source.getMap(map);
+    return replica.version == source.getVersion()
+        && replica.map.info.width == map.info.width
+        && replica.map.info.height == map.info.height
+        && replica.map.data == map.data;
+  }
+}
+
+int main()
+{
+  NS_Test::removeService(SERVICE_NAME);
+
+  MapSync source(HISTORY, 0.25);
+  Server< ServiceMapUpdate > server(
+      SERVICE_NAME, boost::bind(&MapSync::serve, &source, _1));
+  Client< ServiceMapUpdate > client(SERVICE_NAME);
+
+  Replica replica;
+  replica.version = 0;
+  ServiceMapUpdate srv;
+
+  /*
+   * there is nothing to patch before the first map
+   */
+  CHECK(!source.update(patch(0, 0, 1, 1, 1)));
+  CHECK(!sync(client, replica, srv));
+  CHECK(!srv.result);
+  CHECK(replica.version == 0);
+
+  /*
+   * a replica without a version gets the whole map
+   */
+  source.setMap(makeMap(0));
+  CHECK(sync(client, replica, srv));
+  CHECK(srv.full);
+  CHECK(sameMap(source, replica));
+
+  /*
+   * one which is up to date gets neither patches nor the map
+   */
+  uint64_t version = replica.version;
+  CHECK(sync(client, replica, srv));
+  CHECK(!srv.full && srv.updates.empty() && srv.map.data.empty());
+  CHECK(replica.version == version);
+  CHECK(sameMap(source, replica));
+
+  /*
+   * after a few overlapping changes, a patch for each of them, cut from the
+   * current map
+   */
+  for(int i = 0; i < 5; i++)
+  {
+    CHECK(source.update(patch(i * 2, i, 6, 5, (char)(10 + i))));
+  }
+  CHECK(sync(client, replica, srv));
+  CHECK(!srv.full);
+  CHECK(srv.updates.size() == 5);
+  CHECK(sameMap(source, replica));
+
+  /*
+   * more changes than the history holds need the whole map
+   */
+  for(size_t i = 0; i < HISTORY + 2; i++)
+  {
+    CHECK(source.update(patch((int)i, (int)i, 2, 2, (char)(20 + i))));
+  }
+  CHECK(sync(client, replica, srv));
+  CHECK(srv.full);
+  CHECK(sameMap(source, replica));
+
+  /*
+   * so does a change covering more than a quarter of the map
+   */
+  CHECK(source.update(patch(0, 0, 40, 30, 50)));
+  CHECK(sync(client, replica, srv));
+  CHECK(srv.full);
+  CHECK(sameMap(source, replica));
+
+  /*
+   * and a map replaced since, even when its version is remembered
+   */
+  CHECK(source.update(patch(1, 1, 1, 1, 60)));
+  source.setMap(makeMap(1));
+  CHECK(source.update(patch(2, 2, 1, 1, 61)));
+  CHECK(sync(client, replica, srv));
+  CHECK(srv.full);
+  CHECK(sameMap(source, replica));
+
+  /*
+   * a patch which does not fit the replica is refused and drops its
+   * version, the next request gets the whole map again
+   */
+  ServiceMapUpdate foreign;
+  foreign.result = true;
+  foreign.version = source.getVersion() + 1;
+  foreign.updates.push_back(patch(WIDTH - 1, 0, 2, 1, 70));
+  CHECK(!applyMapSync(foreign, replica.map, replica.version));
+  CHECK(replica.version == 0);
+
+  CHECK(sync(client, replica, srv));
+  CHECK(srv.full);
+  CHECK(sameMap(source, replica));
+
+  NS_Test::removeService(SERVICE_NAME);
+  return NS_Test::result("TestMapSync");
+}
@@ -0,0 +1,202 @@
+/*
+ * TestServiceCall.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ */
+
+/*
+ * request slots: concurrent clients get their own replies, the workers of
+ * a server answer them in parallel, and calls that time out give their
+ * slots back. A server driven by a callback queue answers as well
+ */
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include "../Check.h"
+#include "../../Source/Thread/Atomic.h"
+#include "../../Source/Callbacks/CallbackQueue.h"
+#include "../../Source/Callbacks/Spinner.h"
+#include "../../Source/Service/Server.h"
+#include "../../Source/Service/Client.h"
+#include "../../Source/Service/ServiceType/ServiceMap.h"
+
+using namespace NS_Service;
+typedef NS_ServiceType::ServiceMap MapService;
+
+namespace
+{
+  const char* SERVICE_NAME = "TestServiceCall";
+  const char* QUEUED_NAME = "TestServiceCallQueued";
+
+  const unsigned int WORKERS = 4;
+  const uint32_t CALLERS = 4;
+  const uint32_t CALLS = 100;
+
+  /*
+   * a request asks for twice its width; one with a resolution sleeps that
+   * many milliseconds first
+   */
+  volatile uint32_t serving = 0;
+  volatile uint32_t most_serving = 0;
+
+  void entry(MapService& srv)
+  {
+    uint32_t inside = NS_NaviCommon::atomicFetchAdd(&serving, 1U) + 1;
+    uint32_t most = NS_NaviCommon::atomicLoad(&most_serving);
+    while(inside > most
+        && !NS_NaviCommon::atomicCompareExchange(&most_serving, most, inside))
+    {
+      most = NS_NaviCommon::atomicLoad(&most_serving);
+    }
+
+    if(srv.map.info.resolution > 0)
+    {
+      usleep((useconds_t)(srv.map.info.resolution * 1000));
+    }
+    srv.map.info.height = srv.map.info.width * 2;
+    srv.result = true;
+
+    NS_NaviCommon::atomicFetchAdd(&serving, (uint32_t)-1);
+  }
+
+  MapService request(int16_t width, float delay = 0)
+  {
+    MapService srv;
+    srv.map.info.width = width;
+    srv.map.info.resolution = delay;
+    return srv;
+  }
+
+  volatile uint32_t answered = 0;
+  volatile uint32_t mismatched = 0;
+
+  void caller(Client< MapService >* client, uint32_t index)
+  {
+    for(uint32_t i = 0; i < CALLS; i++)
+    {
+      int16_t width = (int16_t)(index * CALLS + i);
+      MapService srv = request(width);
+      if(!client->call(srv, 2000))
+      {
+        continue;
+      }
+
+      if(srv.result && srv.map.info.height == width * 2)
+      {
+        NS_NaviCommon::atomicFetchAdd(&answered, 1U);
+      }
+      else
+      {
+        NS_NaviCommon::atomicFetchAdd(&mismatched, 1U);
+      }
+    }
+  }
+
+  volatile uint32_t timed_out = 0;
+
+  /*
+   * a request the server takes 300ms for, given up after 50ms
+   */
+  void impatientCaller(Client< MapService >* client)
+  {
+    MapService srv = request(1, 300);
+    if(!client->call(srv, 50))
+    {
+      NS_NaviCommon::atomicFetchAdd(&timed_out, 1U);
+    }
+  }
+
+  /*
+   * slots of the service still held, through a mapping of its own
+   */
+  uint32_t heldSlots(const std::string& name)
+  {
+    mapped_region region;
+    ServiceOperation* operation = attachService(name, region, false);
+    if(!operation)
+    {
+      return SERVICE_SLOTS;
+    }
+
+    scoped_lock< NS_NaviCommon::SharedMutex > lock(operation->lock);
+    uint32_t held = 0;
+    for(uint32_t i = 0; i < SERVICE_SLOTS; i++)
+    {
+      if(operation->slots[i].status != SERVICE_SLOT_FREE)
+      {
+        held++;
+      }
+    }
+    return held;
+  }
+}
+
+int main()
+{
+  NS_Test::removeService(SERVICE_NAME);
+
+  Server< MapService > server(SERVICE_NAME, entry, WORKERS);
+  Client< MapService > client(SERVICE_NAME);
+
+  /*
+   * every caller gets the reply to its own request
+   */
+  boost::thread_group callers;
+  for(uint32_t i = 0; i < CALLERS; i++)
+  {
+    callers.create_thread(boost::bind(caller, &client, i));
+  }
+  callers.join_all();
+
+  CHECK(answered == CALLERS * CALLS);
+  CHECK(mismatched == 0);
+
+  /*
+   * slow requests of as many callers as workers are served side by side
+   */
+  most_serving = 0;
+  for(uint32_t i = 0; i < WORKERS; i++)
+  {
+    callers.create_thread(boost::bind(impatientCaller, &client));
+  }
+  callers.join_all();
+  usleep(400000);
+  CHECK(most_serving == WORKERS);
+
+  /*
+   * calls which give up, taken by a worker or not, leave no slot behind
+   */
+  for(uint32_t i = 0; i < SERVICE_SLOTS; i++)
+  {
+    callers.create_thread(boost::bind(impatientCaller, &client));
+  }
+  callers.join_all();
+  CHECK(timed_out == WORKERS + SERVICE_SLOTS);
+
+  MapService srv = request(21);
+  CHECK(client.call(srv, 2000) && srv.map.info.height == 42);
+
+  usleep(400000);
+  CHECK(heldSlots(SERVICE_NAME) == 0);
+
+  /*
+   * requests served on the threads spinning a callback queue
+   */
+  NS_Test::removeService(QUEUED_NAME);
+  {
+    NS_NaviCommon::CallbackQueue queue;
+    NS_NaviCommon::AsyncSpinner spinner(2, &queue);
+    spinner.start();
+
+    Server< MapService > queued(QUEUED_NAME, entry, 1, &queue);
+    Client< MapService > queued_client(QUEUED_NAME);
+    MapService queued_srv = request(5);
+    CHECK(queued_client.call(queued_srv, 2000)
+        && queued_srv.map.info.height == 10);
+  }
+
+  NS_Test::removeService(SERVICE_NAME);
+  NS_Test::removeService(QUEUED_NAME);
+  return NS_Test::result("TestServiceCall");
+}
@@ -0,0 +1,230 @@
+/*
+ * TestServiceRecovery.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ */
+
+/*
+ * crashed service peers: the slots of clients that died are reclaimed, a
+ * request the dead server was working on is served by the next server, and
+ * a call to a server that died without a successor fails instead of
+ * waiting for its whole timeout
+ */
+
+#include <signal.h>
+#include <time.h>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include "../Check.h"
+#include "../../Source/Thread/Atomic.h"
+#include "../../Source/Service/Server.h"
+#include "../../Source/Service/Client.h"
+#include "../../Source/Service/ServiceType/ServiceMap.h"
+
+using namespace NS_Service;
+typedef NS_ServiceType::ServiceMap MapService;
+
+namespace
+{
+  const char* DEAD_CLIENTS = "TestServiceDeadClients";
+  const char* DEAD_SERVER = "TestServiceDeadServer";
+  const char* GONE_SERVER = "TestServiceGoneServer";
+
+  /*
+   * a request asks for twice its width; one with a resolution sleeps that
+   * many milliseconds first
+   */
+  volatile uint32_t served = 0;
+
+  void entry(MapService& srv)
+  {
+    if(srv.map.info.resolution > 0)
+    {
+      usleep((useconds_t)(srv.map.info.resolution * 1000));
+    }
+    srv.map.info.height = srv.map.info.width * 2;
+    srv.result = true;
+    NS_NaviCommon::atomicFetchAdd(&served, 1U);
+  }
+
+  MapService request(int16_t width, float delay = 0)
+  {
+    MapService srv;
+    srv.map.info.width = width;
+    srv.map.info.resolution = delay;
+    return srv;
+  }
+
+  struct Call
+  {
+    MapService srv;
+    unsigned long timeout;
+    bool replied;
+    double elapsed;
+  };
+
+  double now()
+  {
+    struct timespec spec;
+    clock_gettime(CLOCK_MONOTONIC, &spec);
+    return spec.tv_sec + spec.tv_nsec * 1e-9;
+  }
+
+  void caller(Client< MapService >* client, Call* call)
+  {
+    double start = now();
+    call->replied = client->call(call->srv, call->timeout);
+    call->elapsed = now() - start;
+  }
+
+  /*
+   * slots of the service still held, through a mapping of its own
+   */
+  uint32_t heldSlots(const std::string& name)
+  {
+    mapped_region region;
+    ServiceOperation* operation = attachService(name, region, false);
+    if(!operation)
+    {
+      return SERVICE_SLOTS;
+    }
+
+    scoped_lock< NS_NaviCommon::SharedMutex > lock(operation->lock);
+    uint32_t held = 0;
+    for(uint32_t i = 0; i < SERVICE_SLOTS; i++)
+    {
+      if(operation->slots[i].status != SERVICE_SLOT_FREE)
+      {
+        held++;
+      }
+    }
+    return held;
+  }
+
+  /*
+   * a server peer, serving until it is killed
+   */
+  int serverPeer(const char* name, int ready)
+  {
+    Server< MapService > server(name, entry);
+    NS_Test::signal(ready);
+    for(;;)
+    {
+      pause();
+    }
+    return 0;
+  }
+
+  /*
+   * a client peer, which issues a slow call once told to and is killed
+   * while waiting for it
+   */
+  int clientPeer(int go, int issued)
+  {
+    NS_Test::await(go);
+    Client< MapService > client(DEAD_CLIENTS);
+    NS_Test::signal(issued);
+    MapService srv = request(1, 100);
+    client.call(srv, 10000);
+    return 0;
+  }
+
+  void killPeer(pid_t pid)
+  {
+    ::kill(pid, SIGKILL);
+    waitpid(pid, NULL, 0);
+  }
+}
+
+int main()
+{
+  NS_Test::removeService(DEAD_CLIENTS);
+  NS_Test::removeService(DEAD_SERVER);
+  NS_Test::removeService(GONE_SERVER);
+
+  /*
+   * the peers are forked before this process starts any thread
+   */
+  NS_Test::Pipe ready, go, issued;
+  pid_t dead_server = NS_Test::forkPeer(
+      boost::bind(serverPeer, DEAD_SERVER, ready.writer));
+  pid_t gone_server = NS_Test::forkPeer(
+      boost::bind(serverPeer, GONE_SERVER, ready.writer));
+  pid_t clients[SERVICE_SLOTS];
+  for(uint32_t i = 0; i < SERVICE_SLOTS; i++)
+  {
+    clients[i] = NS_Test::forkPeer(
+        boost::bind(clientPeer, go.reader, issued.writer));
+  }
+  NS_Test::awaitPeers(ready.reader, 2);
+
+  /*
+   * clients killed while their requests fill every slot
+   */
+  {
+    Server< MapService > server(DEAD_CLIENTS, entry);
+    for(uint32_t i = 0; i < SERVICE_SLOTS; i++)
+    {
+      NS_Test::signal(go.writer);
+    }
+    NS_Test::awaitPeers(issued.reader, SERVICE_SLOTS);
+    usleep(50000);
+    for(uint32_t i = 0; i < SERVICE_SLOTS; i++)
+    {
+      killPeer(clients[i]);
+    }
+
+    Client< MapService > client(DEAD_CLIENTS);
+    MapService srv = request(21);
+    CHECK(client.call(srv, 5000) && srv.map.info.height == 42);
+    CHECK(heldSlots(DEAD_CLIENTS) == 0);
+  }
+
+  /*
+   * the server dies while serving a call, the next one answers it
+   */
+  {
+    Client< MapService > client(DEAD_SERVER);
+    Call call = { request(7, 200), 5000, false, 0 };
+    boost::thread calling(boost::bind(caller, &client, &call));
+
+    usleep(100000);
+    killPeer(dead_server);
+    served = 0;
+    Server< MapService > server(DEAD_SERVER, entry);
+    calling.join();
+
+    CHECK(call.replied && call.srv.map.info.height == 14);
+    CHECK(served == 1);
+    CHECK(heldSlots(DEAD_SERVER) == 0);
+  }
+
+  /*
+   * the server dies and nobody takes over: the call gives up after about a
+   * heartbeat period, and the slot it left is freed by the next server
+   */
+  {
+    Client< MapService > client(GONE_SERVER);
+    Call call = { request(7, 5000), 10000, false, 0 };
+    boost::thread calling(boost::bind(caller, &client, &call));
+
+    usleep(100000);
+    killPeer(gone_server);
+    calling.join();
+
+    CHECK(!call.replied);
+    CHECK(call.elapsed < 3 * NS_NaviCommon::HEARTBEAT_PERIOD / 1000.0);
+
+    Server< MapService > server(GONE_SERVER, entry);
+    CHECK(heldSlots(GONE_SERVER) == 0);
+
+    MapService srv = request(21);
+    CHECK(client.call(srv, 2000) && srv.map.info.height == 42);
+  }
+
+  NS_Test::removeService(DEAD_CLIENTS);
+  NS_Test::removeService(DEAD_SERVER);
+  NS_Test::removeService(GONE_SERVER);
+  return NS_Test::result("TestServiceRecovery");
+}
@@ -0,0 +1,341 @@
+/*
+ * ShmStat.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: root
+ *
+ * Dump the statistics and peers of every dataset and service found under
+ * /dev/shm. It is not part of the library; "make shmstat" in Build/ links it
+ * with the toolchain of the board.
+ *
+ *   shmstat [name]            print statistics
+ *   shmstat -c [name]         also reclaim the entries of dead peers and
+ *                             remove the datasets and services nobody alive
+ *                             uses any more
+ *   shmstat -w seconds        watchdog: clean every period, quietly
+ *   shmstat -l                one line per live dataset and service: type,
+ *                             rate and peers
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include "../../Source/DataSet/DataSet.h"
+#include "../../Source/Service/Service.h"
+#include "../../Source/Registry/Registry.h"
+
+using namespace boost::interprocess;
+
+static bool clean = false;
+static bool quiet = false;
+
+static void
+printStatistics(const char* kind, const std::string& name,
+                const NS_NaviCommon::TypeSignature& type,
+                NS_NaviCommon::ChannelStatistics& statistics)
+{
+  printf("%-8s %s\n", kind, name.c_str());
+  printf("  type %s%s, rate %.1f Hz\n",
+         NS_NaviCommon::typeBound(type) ? type.name : "(untyped)",
+         type.fixed_size ? " (fixed size)" : "",
+         NS_NaviCommon::publishRate(statistics));
+  printf("  published %llu, delivered %llu, timeouts %llu\n",
+         (unsigned long long)statistics.published,
+         (unsigned long long)statistics.delivered,
+         (unsigned long long)statistics.timeouts);
+  printf("  bytes %llu, max payload %llu\n",
+         (unsigned long long)statistics.bytes,
+         (unsigned long long)statistics.max_length);
+
+  uint64_t total = 0;
+  for(int i = 0; i < NS_NaviCommon::STATISTICS_LATENCY_BUCKETS; i++)
+  {
+    total += statistics.latency[i];
+  }
+
+  if(total == 0)
+  {
+    return;
+  }
+
+  printf("  latency (us):");
+  uint64_t count = 0;
+  int p50 = -1, p99 = -1;
+  for(int i = 0; i < NS_NaviCommon::STATISTICS_LATENCY_BUCKETS; i++)
+  {
+    if(statistics.latency[i] == 0)
+    {
+      continue;
+    }
+
+    printf(" <%llu:%llu", 2ULL << i,
+           (unsigned long long)statistics.latency[i]);
+
+    count += statistics.latency[i];
+    if(p50 < 0 && count * 2 >= total)
+    {
+      p50 = i;
+    }
+    if(p99 < 0 && count * 100 >= total * 99)
+    {
+      p99 = i;
+    }
+  }
+  printf("\n  p50 < %llu us, p99 < %llu us\n", 2ULL << p50, 2ULL << p99);
+}
+
+static void
+printPeer(const char* kind, uint32_t pid, uint64_t heartbeat)
+{
+  uint64_t current = NS_NaviCommon::SharedEvent::now();
+  printf("  %s pid %u %s, seen %llu ms ago\n", kind, pid,
+         NS_NaviCommon::processAlive(pid) ? "alive" : "dead",
+         (unsigned long long)(
+             current > heartbeat ? (current - heartbeat) / 1000000 : 0));
+}
+
+static void
+inspectDataSet(const std::string& name,
+               NS_DataSet::DataSetOperation* operation)
+{
+  if(!quiet)
+  {
+    printStatistics("dataset", name, operation->type,
+                    operation->statistics);
+
+    printf("  publisher pid %u %s\n", operation->publisher_pid,
+           NS_NaviCommon::processAlive(operation->publisher_pid) ?
+               "alive" : "dead");
+    for(int i = 0; i < NS_DataSet::DATASET_MAX_SUBSCRIBERS; i++)
+    {
+      const NS_DataSet::DataSetReader& reader = operation->readers[i];
+      if(reader.active)
+      {
+        printPeer("subscriber", reader.pid, reader.heartbeat);
+      }
+    }
+  }
+
+  if(!clean)
+  {
+    return;
+  }
+
+  bool retired = false;
+  {
+    scoped_lock< NS_NaviCommon::SharedMutex > lock(operation->lock);
+
+    if(operation->lock.recovered())
+    {
+      NS_DataSet::recoverOperation(operation);
+    }
+
+    int reclaimed = NS_DataSet::reclaimReaders(operation);
+    if(reclaimed)
+    {
+      printf("dataset %s: dropped %d dead subscribers\n", name.c_str(),
+             reclaimed);
+    }
+
+    if(NS_DataSet::abandoned(operation))
+    {
+      NS_NaviCommon::atomicStore(&operation->magic,
+                                 NS_DataSet::DATASET_RETIRED);
+      retired = true;
+    }
+  }
+
+  if(retired)
+  {
+    shared_memory_object::remove(name.c_str());
+    shared_memory_object::remove((name + "_DS").c_str());
+    shared_memory_object::remove((name + "_OBJ").c_str());
+    printf("dataset %s: abandoned, removed\n", name.c_str());
+  }
+}
+
+static void
+inspectService(const std::string& name,
+               NS_Service::ServiceOperation* operation)
+{
+  if(!quiet)
+  {
+    printStatistics("service", name, operation->type,
+                    operation->statistics);
+
+    printPeer("server", operation->server_pid, operation->server_heartbeat);
+  }
+
+  if(!clean)
+  {
+    return;
+  }
+
+  bool retired = false;
+  {
+    scoped_lock< NS_NaviCommon::SharedMutex > lock(operation->lock);
+
+    operation->lock.recovered();
+    NS_Service::reclaimSlots(operation);
+
+    if(NS_Service::serviceAbandoned(operation))
+    {
+      NS_NaviCommon::atomicStore(&operation->magic,
+                                 NS_Service::SERVICE_RETIRED);
+      retired = true;
+    }
+  }
+
+  if(retired)
+  {
+    shared_memory_object::remove(name.c_str());
+    for(uint32_t i = 0; i < NS_Service::SERVICE_SLOTS; i++)
+    {
+      shared_memory_object::remove(
+          NS_Service::serviceArenaName(name, i).c_str());
+    }
+    printf("service %s: abandoned, removed\n", name.c_str());
+  }
+}
+
+static void
+inspect(const std::string& name)
+{
+  boost::interprocess::mode_t mode = clean ? read_write : read_only;
+  shared_memory_object shm;
+  offset_t size = 0;
+
+  try
+  {
+    shm = shared_memory_object(open_only, name.c_str(), mode);
+  }
+  catch(interprocess_exception& exception)
+  {
+    return;
+  }
+
+  if(!shm.get_size(size))
+  {
+    return;
+  }
+
+  if(size == sizeof(NS_DataSet::DataSetOperation))
+  {
+    mapped_region region(shm, mode);
+    NS_DataSet::DataSetOperation* operation =
+        static_cast< NS_DataSet::DataSetOperation* >(region.get_address());
+
+    if(operation->magic == NS_DataSet::DATASET_MAGIC)
+    {
+      inspectDataSet(name, operation);
+    }
+  }
+  else if(size == sizeof(NS_Service::ServiceOperation))
+  {
+    mapped_region region(shm, mode);
+    NS_Service::ServiceOperation* operation =
+        static_cast< NS_Service::ServiceOperation* >(region.get_address());
+
+    if(operation->magic == NS_Service::SERVICE_MAGIC)
+    {
+      inspectService(name, operation);
+    }
+  }
+}
+
+static void
+list()
+{
+  std::vector< NS_NaviCommon::EndpointInfo > endpoints;
+  NS_NaviCommon::listEndpoints(endpoints);
+
+  printf("%-8s %-24s %-40s %10s %7s %5s\n", "kind", "name", "type", "rate(Hz)",
+         "owner", "peers");
+  for(size_t i = 0; i < endpoints.size(); i++)
+  {
+    const NS_NaviCommon::EndpointInfo& info = endpoints[i];
+    printf("%-8s %-24s %-40s %10.1f %7u %5u\n",
+           info.kind == NS_NaviCommon::ENDPOINT_DATASET ? "dataset" : "service",
+           info.name.c_str(),
+           info.type.empty() ? "(untyped)" : info.type.c_str(), info.rate,
+           info.owner, info.peers);
+  }
+}
+
+static void
+scan(const char* only)
+{
+  DIR* dir = opendir("/dev/shm");
+  if(!dir)
+  {
+    perror("/dev/shm");
+    return;
+  }
+
+  std::vector< std::string > names;
+  struct dirent* entry;
+  while((entry = readdir(dir)) != NULL)
+  {
+    if(entry->d_name[0] != '.')
+    {
+      names.push_back(entry->d_name);
+    }
+  }
+  closedir(dir);
+
+  std::sort(names.begin(), names.end());
+
+  for(size_t i = 0; i < names.size(); i++)
+  {
+    if(only && names[i] != only)
+    {
+      continue;
+    }
+    inspect(names[i]);
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  int period = 0;
+  int option;
+  while((option = getopt(argc, argv, "clw:")) != -1)
+  {
+    switch(option)
+    {
+      case 'l':
+        list();
+        return 0;
+      case 'c':
+        clean = true;
+        break;
+      case 'w':
+        clean = true;
+        quiet = true;
+        period = atoi(optarg);
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-c] [-l] [-w seconds] [name]\n", argv[0]);
+        return 1;
+    }
+  }
+
+  const char* only = optind < argc ? argv[optind] : NULL;
+
+  do
+  {
+    scan(only);
+    fflush(stdout);
+  }
+  while(period > 0 && sleep(period) == 0);
+
+  return 0;
+}